@@ -7,6 +7,7 @@
 
 #include "models.h"
 #include "data.h"
+#include "model_builder.h"
 #include <stdexcept>
 #include <memory>
 #include <iostream>
@@ -50,23 +51,6 @@ namespace IVM
 	{
 		char error_text[CPXMESSAGEBUFSIZE];
 		int status = 0;
-		double obj[1];			// Objective function
-		double lb[1];			// Lower bound variables
-		double ub[1];			// Upper bound variables
-		double rhs[1];			// Right-hand side constraints
-		char sense[1];			// Sign of constraint
-		char type[1];			// Type of variable (integer, binary, fractional)
-		int nonzeroes = 0;		// To calculate number of nonzero coefficients in each constraint
-		int matbeg[1];			// Begin position of the constraint
-		std::unique_ptr<int[]> matind; // Position of each element in constraint matrix
-		std::unique_ptr<double[]> matval; // Value of each element in constraint matrix
-
-		matbeg[0] = 0;
-
-		// allocate memory
-		const size_t maxnonzeroes = 100000;
-		matind = std::make_unique<int[]>(maxnonzeroes);
-		matval = std::make_unique<double[]>(maxnonzeroes);
 
 
 		// create the problem
@@ -85,6 +69,11 @@ namespace IVM
 			throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change objective to minimization. \nReason: " + std::string(error_text));
 		}
 
+		// variables and constraints are staged and added in bulk
+		Model_Builder builder(env, problem, "IP_model_allocation::build_problem()");
+		builder.set_batched(_batched_build);
+		builder.set_names(_model_names || _export_model);
+
 
 		// data 
 		const size_t nb_types = data.nb_waste_types();
@@ -96,7 +85,6 @@ namespace IVM
 
 
 		// add variables
-		int nb_variables = -1;
 
 		// variable x_tmdw
 		const int startindex_x_tmdw = 0;
@@ -108,26 +96,8 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_variables;
-
-						obj[0] = 0;
-						lb[0] = 0;
-
-						status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-						}
-
-						// change variable name
-						std::string varname = "x_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-						}
+						auto varname = [&] { return "x_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_column(0, 0, CPX_INFBOUND, 'C', varname);
 					}
 				}
 			}
@@ -143,28 +113,8 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_variables;
-
-						obj[0] = 0;
-						lb[0] = 0;
-						ub[0] = 1;
-						type[0] = 'B';
-
-						status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-						}
-
-						// change variable name
-						std::string varname = "y_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-						}
+						auto varname = [&] { return "y_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_column(0, 0, 1, 'B', varname);
 					}
 				}
 			}
@@ -180,28 +130,8 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_variables;
-
-						obj[0] = 0;
-						lb[0] = 0;
-						ub[0] = 1;
-						type[0] = 'B';
-
-						status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-						}
-
-						// change variable name
-						std::string varname = "z_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-						}
+						auto varname = [&] { return "z_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_column(0, 0, 1, 'B', varname);
 					}
 				}
 			}
@@ -215,34 +145,17 @@ namespace IVM
 			{
 				for (int w = 0; w < nb_weeks; ++w)
 				{
-					++nb_variables;
-
-					obj[0] = 1;
-					lb[0] = 0;
-
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-					}
-
-					// change variable name
-					std::string varname = "beta_" + std::to_string(t + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-					status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-					}
+					auto varname = [&] { return "beta_" + std::to_string(t + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+					builder.add_column(1, 0, CPX_INFBOUND, 'C', varname);
 				}
 			}
 		}
 
+		builder.flush_columns();
+
 
 
 		// add constraints
-		int nb_constraints = -1;
 
 		// 1: x_tmdw <= N y_tmdw   forall t,m,d,w
 		for (int t = 0; t < nb_types; ++t)
@@ -253,138 +166,59 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_constraints;
-
-						rhs[0] = 0;
-						sense[0] = 'L';
-						matbeg[0] = 0;
-
-						nonzeroes = 0;
-
 						// x_tmdw
-						matind[nonzeroes] = startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 
 						// y_tmdw
-						matind[nonzeroes] = startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = -bigM;
-						++nonzeroes;
-
-						if (nonzeroes >= maxnonzeroes)
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-						status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-						}
+						builder.add_coefficient(startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, -bigM);
 
-						// change name of constraint
-						std::string conname = "c1_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-						}
+						auto conname = [&] { return "c1_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_row(0, 'L', conname);
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 2: sum(d,w) x_tmdw == Q_tm   forall t,m
 		for (int t = 0; t < nb_types; ++t)
 		{
 			for (int m = 0; m < nb_zones; ++m)
 			{
-				++nb_constraints;
-
-				const std::string& waste_type = data.waste_type(t);
-				rhs[0] = data.demand(m, waste_type);
-				sense[0] = 'E';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// x_tmdw
 				for (int d = 0; d < nb_days; ++d)
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						matind[nonzeroes] = startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 					}
 				}
 
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c2_" + std::to_string(t + 1) + "_" + std::to_string(m + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c2_" + std::to_string(t + 1) + "_" + std::to_string(m + 1); };
+				builder.add_row(data.demand(m, t), 'E', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 3: sum(d,w) y_tmdw <= W   forall t,m
 		for (int t = 0; t < nb_types; ++t)
 		{
 			for (int m = 0; m < nb_zones; ++m)
 			{
-				++nb_constraints;
-
-				rhs[0] = data.max_visits();
-
-				sense[0] = 'L';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// y_tmdw
 				for (int d = 0; d < nb_days; ++d)
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						matind[nonzeroes] = startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 					}
 				}
 
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c3_" + std::to_string(t + 1) + "_" + std::to_string(m + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c3_" + std::to_string(t + 1) + "_" + std::to_string(m + 1); };
+				builder.add_row(data.max_visits(), 'L', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 4: y_tmdw - z_tmdw <= h_tmdw   forall t,m,d,w
 		for (int t = 0; t < nb_types; ++t)
@@ -395,48 +229,19 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_constraints;
-
-						const std::string& waste_type = data.waste_type(t);
-						rhs[0] = data.current_calendar(m, waste_type, d, w); // convert bool to int
-
-						sense[0] = 'L';
-						matbeg[0] = 0;
-
-						nonzeroes = 0;
-
 						// y_tmdw
-						matind[nonzeroes] = startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 
 						// z_tmdw
-						matind[nonzeroes] = startindex_z_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = -1;
-						++nonzeroes;
-
-						if (nonzeroes >= maxnonzeroes)
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-						status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-						}
+						builder.add_coefficient(startindex_z_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, -1);
 
-						// change name of constraint
-						std::string conname = "c4_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-						}
+						auto conname = [&] { return "c4_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_row(data.current_calendar(m, t, d, w), 'L', conname); // convert bool to int
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 5: y_tmdw + z_tmdw >= h_tmdw   forall t,m,d,w
 		for (int t = 0; t < nb_types; ++t)
@@ -447,62 +252,25 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_constraints;
-
-						const std::string& waste_type = data.waste_type(t);
-						rhs[0] = data.current_calendar(m, waste_type, d, w); // convert bool to int
-
-						sense[0] = 'G';
-						matbeg[0] = 0;
-
-						nonzeroes = 0;
-
 						// y_tmdw
-						matind[nonzeroes] = startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 
 						// z_tmdw
-						matind[nonzeroes] = startindex_z_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
-
-						if (nonzeroes >= maxnonzeroes)
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-						status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-						}
+						builder.add_coefficient(startindex_z_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 
-						// change name of constraint
-						std::string conname = "c5_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-						}
+						auto conname = [&] { return "c5_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_row(data.current_calendar(m, t, d, w), 'G', conname); // convert bool to int
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 6: sum(t,m,d,w) z_tmdw <= pi*theta
 		if(_fraction_allowed_deviations < 0.99)
 		{
-			++nb_constraints;
-
 			int max_deviations = static_cast<int>(_fraction_allowed_deviations * data.nb_pickups_current_calendar() + 0.1);
 
-			rhs[0] = max_deviations;
-			sense[0] = 'L';
-			matbeg[0] = 0;
-
-			nonzeroes = 0;
-
 			// z_tmdw
 			for (int t = 0; t < nb_types; ++t)
 			{
@@ -512,33 +280,16 @@ namespace IVM
 					{
 						for (int w = 0; w < nb_weeks; ++w)
 						{
-							matind[nonzeroes] = startindex_z_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-							matval[nonzeroes] = 1;
-							++nonzeroes;
+							builder.add_coefficient(startindex_z_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 						}
 					}
 				}
 			}
 
-			if (nonzeroes >= maxnonzeroes)
-				throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-			status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-			}
-
-			// change name of constraint
-			std::string conname = "c6";
-			status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-			}
+			auto conname = [&] { return "c6"; };
+			builder.add_row(max_deviations, 'L', conname);
 		}
+		builder.flush_rows();
 
 		// 7: x_tmdw - e_tdw <= A_tw
 		for (int t = 0; t < nb_types; ++t)
@@ -547,15 +298,12 @@ namespace IVM
 			{
 				for (int w = 0; w < nb_weeks; ++w)
 				{
-					++nb_constraints;
-
 					// scenario
 					double Atw = 0;
 					//if (_scenario == FREE_WEEK_FREE_DAY)
 					{
 						for (int m = 0; m < nb_zones; ++m) {
-							const std::string& waste_type = data.waste_type(t);
-							Atw += data.demand(m, waste_type);
+							Atw += data.demand(static_cast<size_t>(m), static_cast<size_t>(t));
 						}
 						Atw /= (nb_days * nb_weeks);
 					}
@@ -570,47 +318,21 @@ namespace IVM
 					else
 						Atw = 0;*/
 
-
-					rhs[0] = Atw;
-					sense[0] = 'L';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// x_tmdw
 					for (int m = 0; m < nb_zones; ++m)
 					{
-						matind[nonzeroes] = startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 					}
 
 					// e_tdw
-					matind[nonzeroes] = startindex_e_tdw + t * nb_days * nb_weeks + d * nb_weeks + w;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
+					builder.add_coefficient(startindex_e_tdw + t * nb_days * nb_weeks + d * nb_weeks + w, -1);
 
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
-
-					// change name of constraint
-					std::string conname = "c7_" + std::to_string(t + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c7_" + std::to_string(t + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+					builder.add_row(Atw, 'L', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 8: x_tmdw + e_tdw >= A_tw
 		for (int t = 0; t < nb_types; ++t)
@@ -619,15 +341,12 @@ namespace IVM
 			{
 				for (int w = 0; w < nb_weeks; ++w)
 				{
-					++nb_constraints;
-
 					// scenario
 					double Atw = 0;
 					//if (_scenario == FREE_WEEK_FREE_DAY) // altijd want vrije keuze
 					{
 						for (int m = 0; m < nb_zones; ++m) {
-							const std::string& waste_type = data.waste_type(t);
-							Atw += data.demand(m, waste_type);
+							Atw += data.demand(static_cast<size_t>(m), static_cast<size_t>(t));
 						}
 						Atw /= (nb_days * nb_weeks);
 					}
@@ -642,47 +361,21 @@ namespace IVM
 					else
 						Atw = 0;*/
 
-
-					rhs[0] = Atw;
-					sense[0] = 'G';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// x_tmdw
 					for (int m = 0; m < nb_zones; ++m)
 					{
-						matind[nonzeroes] = startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 					}
 
 					// e_tdw
-					matind[nonzeroes] = startindex_e_tdw + t * nb_days * nb_weeks + d * nb_weeks + w;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
-
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
+					builder.add_coefficient(startindex_e_tdw + t * nb_days * nb_weeks + d * nb_weeks + w, 1);
 
-					// change name of constraint
-					std::string conname = "c8_" + std::to_string(t + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c8_" + std::to_string(t + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+					builder.add_row(Atw, 'G', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// Enkel indien scenario van toepassing is
 		if (_scenario == FIXED_WEEK_SAME_DAY)
@@ -692,42 +385,14 @@ namespace IVM
 			{
 				for (int d = 0; d < nb_days; ++d)
 				{
-					++nb_constraints;
-
-					rhs[0] = 0;
-					sense[0] = 'E';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// y_1,md,1
-					matind[nonzeroes] = startindex_y_tmdw + 0 * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 0;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
+					builder.add_coefficient(startindex_y_tmdw + 0 * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 0, 1);
 
 					// y_2,md,2
-					matind[nonzeroes] = startindex_y_tmdw + 1 * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 1;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
+					builder.add_coefficient(startindex_y_tmdw + 1 * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 1, -1);
 
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
-
-					// change name of constraint
-					std::string conname = "c9_" + std::to_string(m + 1) + "_" + std::to_string(d + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c9_" + std::to_string(m + 1) + "_" + std::to_string(d + 1); };
+					builder.add_row(0, 'E', conname);
 				}
 			}
 
@@ -736,45 +401,18 @@ namespace IVM
 			{
 				for (int d = 0; d < nb_days; ++d)
 				{
-					++nb_constraints;
-
-					rhs[0] = 0;
-					sense[0] = 'E';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// y_1,md,1
-					matind[nonzeroes] = startindex_y_tmdw + 0 * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 1;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
+					builder.add_coefficient(startindex_y_tmdw + 0 * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 1, 1);
 
 					// y_2,md,2
-					matind[nonzeroes] = startindex_y_tmdw + 1 * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 0;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+					builder.add_coefficient(startindex_y_tmdw + 1 * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 0, -1);
 
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
-
-					// change name of constraint
-					std::string conname = "c9bis_" + std::to_string(m + 1) + "_" + std::to_string(d + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c9bis_" + std::to_string(m + 1) + "_" + std::to_string(d + 1); };
+					builder.add_row(0, 'E', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// Enkel indien scenario van toepassing is
 		if (_scenario == FIXED_WEEK_FREE_DAY)
@@ -785,46 +423,21 @@ namespace IVM
 			{
 				for (int w = 0; w < nb_weeks; ++w)
 				{
-					++nb_constraints;
-
-					rhs[0] = 1;
-					sense[0] = 'L';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// sum(t,d) y_tmdw
 					for (int t = 0; t < nb_types; ++t)
 					{
 						for (int d = 0; d < nb_days; ++d)
 						{
-							matind[nonzeroes] = startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w;
-							matval[nonzeroes] = 1;
-							++nonzeroes;
+							builder.add_coefficient(startindex_y_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + w, 1);
 						}
 					}
 
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
-
-					// change name of constraint
-					std::string conname = "c10_" + std::to_string(m + 1) + "_" + std::to_string(w + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c10_" + std::to_string(m + 1) + "_" + std::to_string(w + 1); };
+					builder.add_row(1, 'L', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// Enkel indien scenario van toepassing is
 		if (_scenario == CURRENT_CALENDAR) // elke week restafval
@@ -836,55 +449,33 @@ namespace IVM
 				{
 					for (int d = 0; d < nb_days; ++d)
 					{
-						++nb_constraints;
-
-						rhs[0] = 0;
-						sense[0] = 'E';
-						matbeg[0] = 0;
-
-						nonzeroes = 0;
-
 						// x_tmd0
-						matind[nonzeroes] = startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 0;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 0, 1);
 
 						// x_tmd1
-						matind[nonzeroes] = startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 1;
-						matval[nonzeroes] = -1;
-						++nonzeroes;
-
-						if (nonzeroes >= maxnonzeroes)
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-						status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-						}
+						builder.add_coefficient(startindex_x_tmdw + t * nb_zones * nb_days * nb_weeks + m * nb_days * nb_weeks + d * nb_weeks + 1, -1);
 
-						// change name of constraint
-						std::string conname = "c12_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1);
-						status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-						}
+						auto conname = [&] { return "c12_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1); };
+						builder.add_row(0, 'E', conname);
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
+		builder.print_statistics();
 
 
-		// write to file
-		status = CPXwriteprob(env, problem, "IP_model_allocation.lp", NULL);
-		if (status != 0)
+		// write to file (only on request, as compressed SAV file)
+		if (_export_model)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't write problem to lp-file. \nReason: " + std::string(error_text));
+			std::string filename = "IP_model_allocation.sav.gz";
+			status = CPXwriteprob(env, problem, filename.c_str(), NULL);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_allocation::build_problem(). \nCouldn't write problem to sav-file. \nReason: " + std::string(error_text));
+			}
 		}
 	}
 
@@ -1126,6 +717,30 @@ namespace IVM
 		clear_cplex();
 	}
 
+	void IP_model_allocation::benchmark_build(const Instance& data)
+	{
+		std::cout << "\n\nBenchmark building the allocation model";
+
+		// reference: one call to CPLEX per variable and constraint, then in bulk
+		double build_time[2];
+		for (int batched = 0; batched < 2; ++batched)
+		{
+			_batched_build = (batched == 1);
+
+			initialize_cplex();
+			auto start_time = std::chrono::system_clock::now();
+			build_problem(data);
+			std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+			build_time[batched] = elapsed_time.count();
+			clear_cplex();
+		}
+		_batched_build = true;
+
+		std::cout << "\n\nBuild time one call per variable/constraint (s): " << build_time[0];
+		std::cout << "\nBuild time in bulk (s): " << build_time[1];
+		std::cout << "\nSpeedup: " << build_time[0] / build_time[1];
+	}
+
 	const std::string IP_model_allocation::scenario_name() const
 	{
 		if (_scenario == Scenario::FIXED_WEEK_SAME_DAY)
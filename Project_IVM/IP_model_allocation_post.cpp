@@ -7,11 +7,14 @@
 
 #include "models.h"
 #include "data.h"
+#include "model_builder.h"
 #include <stdexcept>
 #include <memory>
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <sstream>
+#include <cstring>
 
 
 
@@ -50,23 +53,6 @@ namespace IVM
 	{
 		char error_text[CPXMESSAGEBUFSIZE];
 		int status = 0;
-		double obj[1];			// Objective function
-		double lb[1];			// Lower bound variables
-		double ub[1];			// Upper bound variables
-		double rhs[1];			// Right-hand side constraints
-		char sense[1];			// Sign of constraint
-		char type[1];			// Type of variable (integer, binary, fractional)
-		int nonzeroes = 0;		// To calculate number of nonzero coefficients in each constraint
-		int matbeg[1];			// Begin position of the constraint
-		std::unique_ptr<int[]> matind; // Position of each element in constraint matrix
-		std::unique_ptr<double[]> matval; // Value of each element in constraint matrix
-
-		matbeg[0] = 0;
-
-		// allocate memory
-		const size_t maxnonzeroes = 100000;
-		matind = std::make_unique<int[]>(maxnonzeroes);
-		matval = std::make_unique<double[]>(maxnonzeroes);
 
 
 		// create the problem
@@ -85,6 +71,11 @@ namespace IVM
 			throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change objective to minimization. \nReason: " + std::string(error_text));
 		}
 
+		// variables and constraints are staged and added in bulk
+		Model_Builder builder(env, problem, "IP_model_allocation_post::build_problem()");
+		builder.set_batched(_batched_build);
+		builder.set_names(_model_names || _export_model);
+
 
 		// data 
 		const size_t nb_routes = data.nb_routes();
@@ -95,7 +86,6 @@ namespace IVM
 
 
 		// add variables
-		int nb_variables = -1;
 
 		// variable x_rdw
 		const int startindex_x_rdw = 0;
@@ -105,28 +95,8 @@ namespace IVM
 			{
 				for (int w = 0; w < nb_weeks; ++w)
 				{
-					++nb_variables;
-
-					obj[0] = 0;
-					lb[0] = 0;
-					ub[0] = 1;
-					type[0] = 'B';
-
-					status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-					}
-
-					// change variable name
-					std::string varname = "x_" + std::to_string(r + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-					status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-					}
+					auto varname = [&] { return "x_" + std::to_string(r + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+					builder.add_column(0, 0, 1, 'B', varname);
 				}
 			}
 		}
@@ -141,28 +111,8 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_variables;
-
-						obj[0] = 0;
-						lb[0] = 0;
-						ub[0] = 1;
-						type[0] = 'B';
-
-						status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-						}
-
-						// change variable name
-						std::string varname = "y_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-						}
+						auto varname = [&] { return "y_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_column(0, 0, 1, 'B', varname);
 					}
 				}
 			}
@@ -178,28 +128,8 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_variables;
-
-						obj[0] = _objcoeff_z_tmdw;
-						lb[0] = 0;
-						ub[0] = 1;
-						type[0] = 'B';
-
-						status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-						}
-
-						// change variable name
-						std::string varname = "z_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-						}
+						auto varname = [&] { return "z_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_column(_objcoeff_z_tmdw, 0, 1, 'B', varname);
 					}
 				}
 			}
@@ -208,27 +138,8 @@ namespace IVM
 		// variabele beta
 		const int startindex_beta = startindex_z_tmdw + nb_types * nb_zones * nb_days * nb_weeks;
 		{
-			++nb_variables;
-
-			obj[0] = _objcoeff_beta;
-			lb[0] = 0;
-			type[0] = 'I';
-
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, type, NULL);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-			}
-
-			// change variable name
-			std::string varname = "beta";
-			status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-			}
+			auto varname = [&] { return "beta"; };
+			builder.add_column(_objcoeff_beta, 0, CPX_INFBOUND, 'I', varname);
 		}
 
 		// variable theta_tm or theta_r
@@ -237,27 +148,8 @@ namespace IVM
 		{
 			for (int r = 0; r < nb_routes; ++r)
 			{
-				++nb_variables;
-
-				obj[0] = _objcoeff_theta * data.route_nb_times_used(r);
-				lb[0] = 0;
-				type[0] = 'I';
-
-				status = CPXnewcols(env, problem, 1, obj, lb, NULL, type, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-				}
-
-				// change variable name
-				std::string varname = "theta_" + std::to_string(r + 1);
-				status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-				}
+				auto varname = [&] { return "theta_" + std::to_string(r + 1); };
+				builder.add_column(_objcoeff_theta * data.route_nb_times_used(r), 0, CPX_INFBOUND, 'I', varname);
 			}
 		}
 		else
@@ -266,27 +158,8 @@ namespace IVM
 			{
 				for (int m = 0; m < nb_zones; ++m)
 				{
-					++nb_variables;
-
-					obj[0] = _objcoeff_theta;
-					lb[0] = 0;
-					type[0] = 'I';
-
-					status = CPXnewcols(env, problem, 1, obj, lb, NULL, type, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-					}
-
-					// change variable name
-					std::string varname = "theta_" + std::to_string(t + 1) + "_" + std::to_string(m + 1);
-					status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-					}
+					auto varname = [&] { return "theta_" + std::to_string(t + 1) + "_" + std::to_string(m + 1); };
+					builder.add_column(_objcoeff_theta, 0, CPX_INFBOUND, 'I', varname);
 				}
 			}
 		}
@@ -309,166 +182,139 @@ namespace IVM
 			return startindex_theta + r;
 			};
 
+		builder.flush_columns();
+
+
 
 		// add constraints
-		int nb_constraints = -1;
 
 		// 1: sum(d,w) x_rdw == 1 - theta_r   forall r
 		for (int r = 0; r < nb_routes; ++r)
 		{
-			++nb_constraints;
-
-			rhs[0] = 1;
-			sense[0] = 'E';
-			matbeg[0] = 0;
-
-			nonzeroes = 0;
-
 			// x_tmdw
 			for (int d = 0; d < nb_days; ++d)
 			{
 				for (int w = 0; w < nb_weeks; ++w)
 				{
-					matind[nonzeroes] = index_x_rdw(r, d, w);
-					matval[nonzeroes] = 1;
-					++nonzeroes;
+					builder.add_coefficient(index_x_rdw(r, d, w), 1);
 				}
 			}
 
 			if (_penalty_on_route_assignment)
 			{
 				// theta_r
-				matind[nonzeroes] = index_theta_r(r);
-				matval[nonzeroes] = 1;
-				++nonzeroes;
-			}
-
-			if (nonzeroes >= maxnonzeroes)
-				throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-			status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
+				builder.add_coefficient(index_theta_r(r), 1);
 			}
 
-			// change name of constraint
-			std::string conname = "c1_" + std::to_string(r + 1);
-			status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-			}
+			auto conname = [&] { return "c1_" + std::to_string(r + 1); };
+			builder.add_row(1, 'E', conname);
 		}
+		builder.flush_rows();
 
 		// 2: sum(r) n_r x_rdw <= beta   forall d,w
 		for (int d = 0; d < nb_days; ++d)
 		{
 			for (int w = 0; w < nb_weeks; ++w)
 			{
-				++nb_constraints;
-
-				rhs[0] = 0;
-				sense[0] = 'L';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// x_rdw
 				for (int r = 0; r < nb_routes; ++r)
 				{
-					matind[nonzeroes] = index_x_rdw(r, d, w);
-					matval[nonzeroes] = data.route_nb_times_used(r);
-					++nonzeroes;
+					builder.add_coefficient(index_x_rdw(r, d, w), data.route_nb_times_used(r));
 				}
 
 				// beta
-				{
-					matind[nonzeroes] = startindex_beta;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-				}
-
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
+				builder.add_coefficient(startindex_beta, -1);
 
-				// change name of constraint
-				std::string conname = "c2_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c2_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+				builder.add_row(0, 'L', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 3: a_rm b_rt x_rdw <= y_tmdw   forall r,t,m,d,w
-		for (int r = 0; r < nb_routes; ++r)
+		//    for a route that does not visit zone m or picks up another waste type, the row is -y_tmdw <= 0 (redundant),
+		//    so only the rows of the routes that visit the zone are generated (see C3_Generation)
+		const int startindex_c3 = builder.nb_rows();
+		if (_c3_generation == C3_DENSE)
 		{
-			for (int t = 0; t < nb_types; ++t)
+			for (int r = 0; r < nb_routes; ++r)
 			{
-				for (int m = 0; m < nb_zones; ++m)
+				for (int t = 0; t < nb_types; ++t)
 				{
-					for (int d = 0; d < nb_days; ++d)
+					for (int m = 0; m < nb_zones; ++m)
 					{
-						for (int w = 0; w < nb_weeks; ++w)
+						for (int d = 0; d < nb_days; ++d)
 						{
-							++nb_constraints;
-
-							rhs[0] = 0;
-							sense[0] = 'L';
-							matbeg[0] = 0;
+							for (int w = 0; w < nb_weeks; ++w)
+							{
+								// x_rdw
+								{
+									const bool route_type = (data.route_waste_type_index(r) == static_cast<size_t>(t));
+									builder.add_coefficient(index_x_rdw(r, d, w), data.route_visits_zone(r, m) * route_type); // bool to int
+								}
 
-							nonzeroes = 0;
+								// y_tmdw
+								builder.add_coefficient(index_y_tmdw(t, m, d, w), -1);
 
-							// x_rdw
-							{
-								const std::string& waste_type = data.waste_type(t);
-								matind[nonzeroes] = index_x_rdw(r, d, w);
-								matval[nonzeroes] = data.route_visits_zone(r, m) * data.route_waste_type(r, waste_type); // bool to int
-								++nonzeroes;
+								auto conname = [&] { return "c3_" + std::to_string(t + 1) + "_" + std::to_string(m + 1); };
+								builder.add_row(0, 'L', conname);
 							}
+						}
+					}
+				}
+			}
+		}
+		else
+		{
+			for (int m = 0; m < nb_zones; ++m)
+			{
+				const std::vector<size_t> routes_m = data.routes_visiting_zone(m);
+				for (int t = 0; t < nb_types; ++t)
+				{
+					// routes r with a_rm b_rt == 1
+					std::vector<size_t> routes_tm;
+					for (size_t r : routes_m)
+					{
+						if (data.route_waste_type_index(r) == static_cast<size_t>(t))
+							routes_tm.push_back(r);
+					}
+					if (routes_tm.empty())
+						continue;
 
-							// y_tmdw
+					for (int d = 0; d < nb_days; ++d)
+					{
+						for (int w = 0; w < nb_weeks; ++w)
+						{
+							if (_c3_generation == C3_AGGREGATED)
 							{
-								matind[nonzeroes] = index_y_tmdw(t, m, d, w);
-								matval[nonzeroes] = -1;
-								++nonzeroes;
-							}
-
-							if (nonzeroes >= maxnonzeroes)
-								throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+								// sum(r) x_rdw - n_tm y_tmdw <= 0
+								for (size_t r : routes_tm)
+									builder.add_coefficient(index_x_rdw(r, d, w), 1);
+								builder.add_coefficient(index_y_tmdw(t, m, d, w), -static_cast<double>(routes_tm.size()));
 
-							status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
+								auto conname = [&] { return "c3_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+								builder.add_row(0, 'L', conname);
 							}
-
-							// change name of constraint
-							std::string conname = "c3_" + std::to_string(t + 1) + "_" + std::to_string(m + 1);
-							status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-							if (status != 0)
+							else
 							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
+								// x_rdw - y_tmdw <= 0
+								for (size_t r : routes_tm)
+								{
+									builder.add_coefficient(index_x_rdw(r, d, w), 1);
+									builder.add_coefficient(index_y_tmdw(t, m, d, w), -1);
+
+									auto conname = [&] { return "c3_" + std::to_string(r + 1) + "_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+									builder.add_row(0, 'L', conname);
+								}
 							}
 						}
 					}
 				}
 			}
 		}
+		builder.flush_rows();
+		_nb_rows_c3 = static_cast<size_t>(builder.nb_rows() - startindex_c3);
+		std::cout << "\nConstraint 3: " << _nb_rows_c3 << " rows (of " << nb_routes * nb_types * nb_zones * nb_days * nb_weeks << " for every r,t,m,d,w)";
 
 		// 4: y_tmdw <= V_md   forall t,m,d,w
 		for (int t = 0; t < nb_types; ++t)
@@ -479,96 +325,42 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_constraints;
-
-						rhs[0] = !data.zone_forbidden_day(m,d); // bool to int
-						sense[0] = 'L';
-						matbeg[0] = 0;
-
-						nonzeroes = 0;
-
 						// y_tmdw
-						{
-							matind[nonzeroes] = index_y_tmdw(t, m, d, w);
-							matval[nonzeroes] = 1;
-							++nonzeroes;
-						}
-
-						if (nonzeroes >= maxnonzeroes)
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-						status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-						}
+						builder.add_coefficient(index_y_tmdw(t, m, d, w), 1);
 
-						// change name of constraint
-						std::string conname = "c4_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) +"_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-						}
+						auto conname = [&] { return "c4_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) +"_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_row(!data.zone_forbidden_day(m,d), 'L', conname); // bool to int
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 5: sum(d,w) y_tmdw - theta_tm <= W   forall t,m
 		for (int t = 0; t < nb_types; ++t)
 		{
 			for (int m = 0; m < nb_zones; ++m)
 			{
-				++nb_constraints;
-
-				rhs[0] = data.max_visits();
-				sense[0] = 'L';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// y_tmdw
 				for (int d = 0; d < nb_days; ++d)
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						matind[nonzeroes] = index_y_tmdw(t, m, d, w);
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(index_y_tmdw(t, m, d, w), 1);
 					}
 				}
 
 				// theta_tm
 				if(!_penalty_on_route_assignment)
 				{
-					matind[nonzeroes] = index_theta_tm(t, m);
-					matval[nonzeroes] = -1;
-					++nonzeroes;
+					builder.add_coefficient(index_theta_tm(t, m), -1);
 				}
 
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c5_" + std::to_string(t + 1) + "_" + std::to_string(m + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c5_" + std::to_string(t + 1) + "_" + std::to_string(m + 1); };
+				builder.add_row(data.max_visits(), 'L', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 6: y_tmdw - z_tmdw <= h_tmdw   forall t,m,d,w
 		for (int t = 0; t < nb_types; ++t)
@@ -579,48 +371,19 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_constraints;
-
-						const std::string& waste_type = data.waste_type(t);
-						rhs[0] = data.current_calendar(m, waste_type, d, w); // convert bool to int
-
-						sense[0] = 'L';
-						matbeg[0] = 0;
-
-						nonzeroes = 0;
-
 						// y_tmdw
-						matind[nonzeroes] = index_y_tmdw(t, m, d, w);
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(index_y_tmdw(t, m, d, w), 1);
 
 						// z_tmdw
-						matind[nonzeroes] = index_z_tmdw(t, m, d, w);
-						matval[nonzeroes] = -1;
-						++nonzeroes;
-
-						if (nonzeroes >= maxnonzeroes)
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-						status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-						}
+						builder.add_coefficient(index_z_tmdw(t, m, d, w), -1);
 
-						// change name of constraint
-						std::string conname = "c6_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-						}
+						auto conname = [&] { return "c6_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_row(data.current_calendar(m, t, d, w), 'L', conname); // convert bool to int
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 7: y_tmdw + z_tmdw >= h_tmdw   forall t,m,d,w
 		for (int t = 0; t < nb_types; ++t)
@@ -631,48 +394,19 @@ namespace IVM
 				{
 					for (int w = 0; w < nb_weeks; ++w)
 					{
-						++nb_constraints;
-
-						const std::string& waste_type = data.waste_type(t);
-						rhs[0] = data.current_calendar(m, waste_type, d, w); // convert bool to int
-
-						sense[0] = 'G';
-						matbeg[0] = 0;
-
-						nonzeroes = 0;
-
 						// y_tmdw
-						matind[nonzeroes] = index_y_tmdw(t, m, d, w);
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(index_y_tmdw(t, m, d, w), 1);
 
 						// z_tmdw
-						matind[nonzeroes] = index_z_tmdw(t, m, d, w);
-						matval[nonzeroes] = 1;
-						++nonzeroes;
-
-						if (nonzeroes >= maxnonzeroes)
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-						status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-						}
+						builder.add_coefficient(index_z_tmdw(t, m, d, w), 1);
 
-						// change name of constraint
-						std::string conname = "c7_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1);
-						status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-						}
+						auto conname = [&] { return "c7_" + std::to_string(t + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(d + 1) + "_" + std::to_string(w + 1); };
+						builder.add_row(data.current_calendar(m, t, d, w), 'G', conname); // convert bool to int
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// Enkel indien scenario van toepassing is
 		if (_scenario == FIXED_WEEK_SAME_DAY)
@@ -682,42 +416,14 @@ namespace IVM
 			{
 				for (int d = 0; d < nb_days; ++d)
 				{
-					++nb_constraints;
-
-					rhs[0] = 0;
-					sense[0] = 'E';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// y_1,md,1
-					matind[nonzeroes] = index_y_tmdw(0, m, d, 0); 
-					matval[nonzeroes] = 1;
-					++nonzeroes;
+					builder.add_coefficient(index_y_tmdw(0, m, d, 0), 1);
 
 					// y_2,md,2
-					matind[nonzeroes] = index_y_tmdw(1, m, d, 1);
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
+					builder.add_coefficient(index_y_tmdw(1, m, d, 1), -1);
 
-					// change name of constraint
-					std::string conname = "c8_" + std::to_string(m + 1) + "_" + std::to_string(d + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c8_" + std::to_string(m + 1) + "_" + std::to_string(d + 1); };
+					builder.add_row(0, 'E', conname);
 				}
 			}
 
@@ -726,45 +432,18 @@ namespace IVM
 			{
 				for (int d = 0; d < nb_days; ++d)
 				{
-					++nb_constraints;
-
-					rhs[0] = 0;
-					sense[0] = 'E';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// y_1,md,1
-					matind[nonzeroes] = index_y_tmdw(0, m, d, 1); 
-					matval[nonzeroes] = 1;
-					++nonzeroes;
+					builder.add_coefficient(index_y_tmdw(0, m, d, 1), 1);
 
 					// y_2,md,2
-					matind[nonzeroes] = index_y_tmdw(1, m, d, 0); 
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
+					builder.add_coefficient(index_y_tmdw(1, m, d, 0), -1);
 
-					// change name of constraint
-					std::string conname = "c8bis_" + std::to_string(m + 1) + "_" + std::to_string(d + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c8bis_" + std::to_string(m + 1) + "_" + std::to_string(d + 1); };
+					builder.add_row(0, 'E', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// Enkel indien scenario van toepassing is
 		if (_scenario == FIXED_WEEK_FREE_DAY)
@@ -775,55 +454,35 @@ namespace IVM
 			{
 				for (int w = 0; w < nb_weeks; ++w)
 				{
-					++nb_constraints;
-
-					rhs[0] = 1;
-					sense[0] = 'L';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// sum(t,d) y_tmdw
 					for (int t = 0; t < nb_types; ++t)
 					{
 						for (int d = 0; d < nb_days; ++d)
 						{
-							matind[nonzeroes] = index_y_tmdw(t, m, d, w); 
-							matval[nonzeroes] = 1;
-							++nonzeroes;
+							builder.add_coefficient(index_y_tmdw(t, m, d, w), 1);
 						}
 					}
 
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
-
-					// change name of constraint
-					std::string conname = "c9_" + std::to_string(m + 1) + "_" + std::to_string(w + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c9_" + std::to_string(m + 1) + "_" + std::to_string(w + 1); };
+					builder.add_row(1, 'L', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
+		builder.print_statistics();
 
 
-		// write to file
-		status = CPXwriteprob(env, problem, "IP_model_allocation_post.lp", NULL);
-		if (status != 0)
+		// write to file (only on request, as compressed SAV file)
+		if (_export_model)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't write problem to lp-file. \nReason: " + std::string(error_text));
+			std::string filename = "IP_model_allocation_post.sav.gz";
+			status = CPXwriteprob(env, problem, filename.c_str(), NULL);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_allocation_post::build_problem(). \nCouldn't write problem to sav-file. \nReason: " + std::string(error_text));
+			}
 		}
 	}
 
@@ -937,11 +596,11 @@ namespace IVM
 								if (val > 0.000001) {
 									solfile << "\nRoute [";
 									for (int ii = 0; ii < data.route(r)._pickups.size(); ++ii) {
-										solfile << data.route(r)._pickups[ii];
+										solfile << data.zone_name(data.route(r)._pickups[ii]);
 										if (ii < data.route(r)._pickups.size() - 1)
 											solfile << ",";
 									}
-									solfile << "], afvaltype = " << data.route(r)._waste_type <<
+									solfile << "], afvaltype = " << data.route_waste_type_name(r) <<
 										", aantal keer = " << data.route(r)._nb_times_used << ", dag = " << data.day_name(d) << ", week " << w + 1;
 								}
 							}
@@ -984,8 +643,8 @@ namespace IVM
 							double val = solution_problem[index_var];
 							if (val > 0.000001) {
 								solfile << "\n";
-								for (auto&& dest : data.route(r)._pickups)
-									solfile << dest << ", ";
+								for (size_t dest : data.route(r)._pickups)
+									solfile << data.zone_name(dest) << ", ";
 								solfile << "aantal_keer = " << data.route_nb_times_used(r);
 							}
 						}
@@ -1035,9 +694,9 @@ namespace IVM
 								double val = solution_problem[index_var];
 								if (val > 0.000001) {
 									solfile << "\n" << w + 1 << "\t" << d + 1 << "\t";
-									solfile << data.route(r)._waste_type << "\t";
+									solfile << data.route_waste_type_name(r) << "\t";
 									for (int ii = 0; ii < data.route(r)._pickups.size(); ++ii) {
-										solfile << data.route(r)._pickups[ii];
+										solfile << data.zone_name(data.route(r)._pickups[ii]);
 										if (ii < data.route(r)._pickups.size() - 1)
 											solfile << ", ";
 									}
@@ -1075,6 +734,45 @@ namespace IVM
 		}
 	}
 
+	void IP_model_allocation_post::benchmark_c3_generation(const Instance& data)
+	{
+		std::cout << "\n\nBenchmark the generation of constraint 3 for the post allocation problem";
+
+		const int c3_generation = _c3_generation;
+		std::ostringstream table;
+		table << "\n\nConstraint 3\tRows c3\tRows\tBuild time (s)\tStatus\tObjective value\tNodes\tSolve time (s)";
+		const char* names[] = { "dense", "sparse", "aggregated" };
+		for (int generation = C3_DENSE; generation <= C3_AGGREGATED; ++generation)
+		{
+			_c3_generation = generation;
+			_objective_value = -1;
+
+			initialize_cplex();
+			auto start_time = std::chrono::system_clock::now();
+			build_problem(data);
+			std::chrono::duration<double, std::ratio<1, 1>> build_time = std::chrono::system_clock::now() - start_time;
+			start_time = std::chrono::system_clock::now();
+			solve_problem(data);
+			std::chrono::duration<double, std::ratio<1, 1>> solve_time = std::chrono::system_clock::now() - start_time;
+
+			char solstat_text[CPXMESSAGEBUFSIZE];
+			if (CPXgetstatstring(env, CPXgetstat(env, problem), solstat_text) == nullptr)
+				std::strcpy(solstat_text, "unknown");
+			table << "\n" << names[generation] << "\t" << _nb_rows_c3 << "\t" << CPXgetnumrows(env, problem) << "\t" << build_time.count()
+				<< "\t" << solstat_text << "\t";
+			if (_objective_value >= 0)
+				table << _objective_value;
+			else
+				table << "-";
+			table << "\t" << CPXgetnodecnt(env, problem) << "\t" << solve_time.count();
+
+			clear_cplex();
+		}
+		_c3_generation = c3_generation;
+
+		std::cout << table.str();
+	}
+
 	void IP_model_allocation_post::run(const Instance& data)
 	{
 		initialize_cplex();
@@ -1083,5 +781,29 @@ namespace IVM
 		clear_cplex();
 	}
 
+	void IP_model_allocation_post::benchmark_build(const Instance& data)
+	{
+		std::cout << "\n\nBenchmark building the post allocation model";
+
+		// reference: one call to CPLEX per variable and constraint, then in bulk
+		double build_time[2];
+		for (int batched = 0; batched < 2; ++batched)
+		{
+			_batched_build = (batched == 1);
+
+			initialize_cplex();
+			auto start_time = std::chrono::system_clock::now();
+			build_problem(data);
+			std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+			build_time[batched] = elapsed_time.count();
+			clear_cplex();
+		}
+		_batched_build = true;
+
+		std::cout << "\n\nBuild time one call per variable/constraint (s): " << build_time[0];
+		std::cout << "\nBuild time in bulk (s): " << build_time[1];
+		std::cout << "\nSpeedup: " << build_time[0] / build_time[1];
+	}
+
 	///////////////////////////////////////////////////////////////////////////////////////////////
 }
@@ -7,12 +7,22 @@
 
 #include "models.h"
 #include "data.h"
+#include "model_builder.h"
 #include <stdexcept>
+#include <cassert>
 #include <memory>
 #include <iostream>
 #include <fstream>
 #include <chrono>
 #include <random>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <sstream>
+#include <cstring>
 
 
 
@@ -45,29 +55,132 @@ namespace IVM
 			CPXgeterrorstring(env, status, error_text);
 			throw std::runtime_error("Error in function IP_model_integrated::initialize_cplex(). \nCouldn't change param SCRIND. \nReason: " + std::string(error_text));
 		}
+
+		// limit the number of threads (if several fix-and-optimize workers run at the same time)
+		if (_nb_threads > 0)
+		{
+			status = CPXsetintparam(env, CPXPARAM_Threads, _nb_threads);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_integrated::initialize_cplex(). \nCouldn't change param Threads. \nReason: " + std::string(error_text));
+			}
+		}
+	}
+
+	void IP_model_integrated::initialize_layout(const Instance& data)
+	{
+		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
+		const size_t nb_trucks = _max_nb_trucks;
+		const size_t nb_segments = _max_nb_segments;
+		const size_t nb_zones = data.nb_zones();
+		const size_t nb_collection_points = data.nb_collection_points();
+		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
+
+		// heuristic sparsification (optional, see set_arc_sparsification()): every zone keeps the arcs to and from its
+		// _arc_k nearest collection points that are not dominated, and only the zones near the depot can be the first zone of a route
+		std::vector<bool> nearest_cp_ic(nb_zones * nb_collection_points, true);
+		if (_arc_k > 0)
+		{
+			for (size_t i = 0; i < nb_zones; ++i)
+			{
+				size_t nb_kept = 0;
+				for (size_t c : data.collection_points_by_driving_time(i))
+				{
+					const bool keep = nb_kept < _arc_k && !data.collection_point_dominated(i, 0, c); // assume one waste type
+					nearest_cp_ic[i * nb_collection_points + c] = keep;
+					if (keep)
+						++nb_kept;
+				}
+			}
+		}
+		const double max_time_depot = data.time_driving_zone_depot_percentile(_arc_depot_percentile);
+		auto sparse_arc_kept = [&](size_t i, size_t j)
+		{
+			if (i == nb_zones && j < nb_zones) // depot - zone
+				return data.time_driving_zone_depot(j) <= max_time_depot;
+			if (i < nb_zones && j > nb_zones) // zone - collection point
+				return static_cast<bool>(nearest_cp_ic[i * nb_collection_points + (j - nb_zones - 1)]);
+			if (i > nb_zones && j < nb_zones) // collection point - zone
+				return static_cast<bool>(nearest_cp_ic[j * nb_collection_points + (i - nb_zones - 1)]);
+			return true;
+		};
+
+		// same order as the variables are added in build_problem()
+		// (only the arcs that a route can use get a variable, see structural_arc(),
+		//  without the arcs from a zone to a dominated collection point, see Instance::collection_point_dominated())
+		_nb_dominated_arcs = 0;
+		_sparsified_arcs.clear();
+		_layout.x_dvijk = Arc_Family(0, nb_days_total, nb_trucks, nb_locations, nb_segments,
+			[&](size_t d, size_t i, size_t j, size_t k)
+			{
+				if (!structural_arc(nb_zones, nb_segments, i, j, k))
+					return false;
+				if (i < nb_zones && j > nb_zones && data.collection_point_dominated(i, 0, j - nb_zones - 1)) // assume one waste type
+				{
+					_nb_dominated_arcs += nb_trucks;
+					return false;
+				}
+				if (!sparse_arc_kept(i, j))
+				{
+					if (d == 0) // the same arcs for every day
+						_sparsified_arcs.push_back(Arc{ static_cast<int>(i), static_cast<int>(j), static_cast<int>(k) });
+					return false;
+				}
+				return true;
+			});
+		_layout.w_dvik = Variable_Family<4>(_layout.x_dvijk.end(), { { nb_days_total, nb_trucks, nb_zones, nb_segments } });
+		_layout.y_dv = Variable_Family<2>(_layout.w_dvik.end(), { { nb_days_total, nb_trucks } });
+		_layout.beta_dv = Variable_Family<2>(_layout.y_dv.end(), { { nb_days_total, nb_trucks } });
+		_layout.z = Variable_Family<0>(_layout.beta_dv.end(), {});
+		_layout.ksi_di = Variable_Family<2>(_layout.z.end(), { { nb_days_total, nb_zones } });
+		_layout.nb_columns = _layout.ksi_di.end();
+	}
+
+	std::vector<std::vector<size_t>> IP_model_integrated::day_symmetry_classes(const Instance& data) const
+	{
+		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
+		const size_t nb_zones = data.nb_zones();
+
+		// The only day-dependent data in the model are the forbidden days (constraint 14),
+		// so days on which the same zones are forbidden are interchangeable
+		std::vector<std::vector<bool>> patterns;
+		std::vector<std::vector<size_t>> day_classes;
+		for (size_t d = 0; d < nb_days_total; ++d)
+		{
+			std::vector<bool> pattern(nb_zones);
+			for (size_t i = 0; i < nb_zones; ++i)
+				pattern[i] = data.zone_forbidden_day(i, d % 5); // day of week, as in constraint 14
+
+			auto it = std::find(patterns.begin(), patterns.end(), pattern);
+			if (it == patterns.end())
+			{
+				patterns.push_back(pattern);
+				day_classes.push_back({ d });
+			}
+			else
+				day_classes[it - patterns.begin()].push_back(d);
+		}
+		return day_classes;
+	}
+
+	double IP_model_integrated::arc_time(const Instance& data, int i, int j) const
+	{
+		const int nb_zones = static_cast<int>(data.nb_zones());
+
+		// driving time (same order of the locations as in the model)
+		double time = data.time_driving(i, j);
+
+		if (i < nb_zones && j > nb_zones) // i == zone, j == collection point
+			time += data.time_unloading(static_cast<size_t>(0)); // MOMENTEEL ZELFDE VERONDERSTELD
+
+		return time;
 	}
 
 	void IP_model_integrated::build_problem(const Instance& data)
 	{
 		char error_text[CPXMESSAGEBUFSIZE];
 		int status = 0;
-		double obj[1];			// Objective function
-		double lb[1];			// Lower bound variables
-		double ub[1];			// Upper bound variables
-		double rhs[1];			// Right-hand side constraints
-		char sense[1];			// Sign of constraint
-		char type[1];			// Type of variable (integer, binary, fractional)
-		int nonzeroes = 0;		// To calculate number of nonzero coefficients in each constraint
-		int matbeg[1];			// Begin position of the constraint
-		std::unique_ptr<int[]> matind; // Position of each element in constraint matrix
-		std::unique_ptr<double[]> matval; // Value of each element in constraint matrix
-
-		matbeg[0] = 0;
-
-		// allocate memory
-		const size_t maxnonzeroes = 100000;
-		matind = std::make_unique<int[]>(maxnonzeroes);
-		matval = std::make_unique<double[]>(maxnonzeroes);
 
 
 		// create the problem
@@ -86,6 +199,11 @@ namespace IVM
 			throw std::runtime_error("Error in function IP_model_integrated::build_problem(). \nCouldn't change objective to minimization. \nReason: " + std::string(error_text));
 		}
 
+		// variables and constraints are staged and added in bulk
+		Model_Builder builder(env, problem, "IP_model_integrated::build_problem()");
+		builder.set_batched(_batched_build);
+		builder.set_names(_model_names || _export_model);
+
 
 		// data 
 		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
@@ -96,53 +214,27 @@ namespace IVM
 		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
 		const size_t max_visits = _max_visits;
 
+		// position of the variables in the problem
+		initialize_layout(data);
+
 
 		// add variables
-		int nb_variables = -1;
 
-		// variable x_dvijk   
-		const int startindex_x_dvijk = 0;
+		// variable x_dvijk   (allowed arcs only)
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
 			{
-				for (int i = 0; i < nb_locations; ++i)
+				for (auto&& arc : _layout.x_dvijk.arcs(d))
 				{
-					for (int j = 0; j < nb_locations; ++j)
-					{
-						for (int k = 0; k < nb_segments; ++k)
-						{
-							++nb_variables;
-
-							obj[0] = 0;
-							lb[0] = 0;
-							ub[0] = 1;
-							type[0] = 'B';
-
-							status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-							}
-
-							// change variable name
-							std::string varname = "x_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_"
-								+ std::to_string(i + 1) + "_" + std::to_string(j + 1) + "_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-							}
-						}
-					}
+					auto varname = [&] { return "x_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_"
+						+ std::to_string(arc.i + 1) + "_" + std::to_string(arc.j + 1) + "_" + std::to_string(arc.k + 1); };
+					builder.add_column(0, 0, 1, 'B', varname);
 				}
 			}
 		}
 
 		// variable w_dvik   
-		const int startindex_w_dvik = startindex_x_dvijk + nb_days_total * nb_trucks * nb_locations * nb_locations * nb_segments;
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
@@ -151,237 +243,74 @@ namespace IVM
 				{
 					for (int k = 0; k < nb_segments; ++k)
 					{
-						++nb_variables;
-
-						obj[0] = 0;
-						lb[0] = 0;
-
-						status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-						}
-
-						// change variable name
-						std::string varname = "w_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1);
-						status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-						}
+						auto varname = [&] { return "w_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1); };
+						builder.add_column(0, 0, CPX_INFBOUND, 'C', varname);
 					}
 				}
 			}
 		}
 
 		// variable y_dv   
-		const int startindex_y_dv = startindex_w_dvik + nb_days_total * nb_trucks * nb_zones * nb_segments;
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
 			{
-				++nb_variables;
-
-				obj[0] = 0;
-				lb[0] = 0;
-				ub[0] = 1;
-				type[0] = 'B';
-
-				status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-				}
-
-				// change variable name
-				std::string varname = "y_" + std::to_string(d + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-				}
+				auto varname = [&] { return "y_" + std::to_string(d + 1) + "_" + std::to_string(v + 1); };
+				builder.add_column(0, 0, 1, 'B', varname);
 			}
 		}
 
 		// variable beta_dv   
-		const int startindex_beta_dv = startindex_y_dv + nb_days_total * nb_trucks;
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
 			{
-				++nb_variables;
-
-				obj[0] = data.operating_costs(0); // assume one truck type
-				lb[0] = 0;
-
-				status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-				}
-
-				// change variable name
-				std::string varname = "beta_" + std::to_string(d + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-				}
+				auto varname = [&] { return "beta_" + std::to_string(d + 1) + "_" + std::to_string(v + 1); };
+				builder.add_column(data.operating_costs(0), 0, CPX_INFBOUND, 'C', varname); // assume one truck type
 			}
 		}
 
 		// variable z
-		const int startindex_z = startindex_beta_dv + nb_days_total * nb_trucks;
 		{
-			++nb_variables;
-
-			obj[0] = nb_days_total * data.fixed_costs(0); // assume one truck type
-			lb[0] = 0;
-			type[0] = 'I';
-
-			status = CPXnewcols(env, problem, 1, obj, lb, NULL, type, NULL);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-			}
-
-			// change variable name
-			std::string varname = "z";
-			status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-			}
+			auto varname = [&] { return "z"; };
+			builder.add_column(nb_days_total * data.fixed_costs(0), 0, CPX_INFBOUND, 'I', varname); // assume one truck type
 		}
 
 		// variable ksi_di
-		const int startindex_ksi_di = startindex_z + 1;
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int m = 0; m < nb_zones; ++m)  // enkel voor zones
 			{
-				++nb_variables;
-
-				obj[0] = 0;
-				lb[0] = 0;
-				ub[0] = 1;
-				type[0] = 'B';
-
-				status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-				}
-
-				// change variable name
-				std::string varname = "ksi_" + std::to_string(d + 1) + std::to_string(m + 1);
-				status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-				}
+				auto varname = [&] { return "ksi_" + std::to_string(d + 1) + std::to_string(m + 1); };
+				builder.add_column(0, 0, 1, 'B', varname);
 			}
 		}
 
-
-		// lambdas to get variable indices
-		auto index_x_dvijk = [startindex_x_dvijk, nb_trucks, nb_locations, nb_segments](int d, int v, int i, int j, int k) -> int {
-			return startindex_x_dvijk + d * nb_trucks * nb_locations * nb_locations * nb_segments + v * nb_locations * nb_locations * nb_segments
-				+ i * nb_locations * nb_segments + j * nb_segments + k;
-			};
-		auto index_w_dvik = [startindex_w_dvik, nb_trucks, nb_zones, nb_segments](int d, int v, int i_zone, int k) -> int {
-			return startindex_w_dvik + d * nb_trucks * nb_zones * nb_segments + v * nb_zones * nb_segments + i_zone * nb_segments + k;
-			};
-		auto index_y_dv = [startindex_y_dv, nb_trucks](int d, int v) -> int {
-			return startindex_y_dv + d * nb_trucks + v;
-			};
-		auto index_beta_dv = [startindex_beta_dv, nb_trucks](int d, int v) -> int {
-			return startindex_beta_dv + d * nb_trucks + v;
-			};
-		auto index_ksi_di = [startindex_ksi_di, nb_zones](int d, int m) -> int {
-			return startindex_ksi_di + d * nb_zones + m;
-			};
-
-
-		nb_variables = CPXgetnumcols(env, problem);
+		builder.flush_columns();
+		assert(static_cast<size_t>(builder.nb_columns()) == _layout.nb_columns);
+		std::cout << "\nArc variables x_dvijk: " << _layout.x_dvijk.size() << " of " << _layout.x_dvijk.dense_size() << " (forbidden arcs not created)";
+		std::cout << "\nArc variables removed by collection point dominance: " << _nb_dominated_arcs;
+		if (_arc_k > 0 || _arc_depot_percentile < 100)
+			std::cout << "\nArc variables removed by sparsification (heuristic, " << _arc_k << " nearest collection points, depot percentile "
+				<< _arc_depot_percentile << "): " << _sparsified_arcs.size() * nb_trucks * nb_days_total;
 
 
 
 		// add constraints
-		int nb_constraints = -1;
 
 		// 1: beta_dv - sum(i,j,k) tau_D_ij*x_dvijk - sum(i,k) tau_P_i*w_dvik - sum(i,j,k) tau_U*x_dvijk == 0   forall d,v
+		_startindex_c1_dv = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
 			{
-				++nb_constraints;
-
-				rhs[0] = 0;
-				sense[0] = 'E';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// beta_dv
-				{
-					const size_t index = index_beta_dv(d, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
-				}
+				builder.add_coefficient(_layout.beta_dv(d, v), 1);
 
 				// -sum(i,j,k) (tau_D_ij + tau_U) * x_dvijk
-				for (int i = 0; i < nb_locations; ++i)
+				for (auto&& arc : _layout.x_dvijk.arcs(d))
 				{
-					for (int j = 0; j < nb_locations; ++j)
-					{
-						for (int k = 0; k < nb_segments; ++k)
-						{
-							double coeff = 0;
-							if (i < nb_zones && j == nb_zones) { // i == zone, j == depot
-								coeff = -data.time_driving_zone_depot(i);
-							}
-							else if (i < nb_zones && j > nb_zones) { // i == zone, j == collection point
-								const std::string& cp = data.collection_point_name(j - nb_zones - 1);
-								coeff += -data.time_driving_zone_collectionpoint(i, cp);
-
-								const std::string& waste_type = data.waste_type(0); // MOMENTEEL ZELFDE VERONDERSTELD
-								coeff += -data.time_unloading(waste_type);
-							}
-							else if (i == nb_zones && j < nb_zones) { // i == depot, j == zone
-								coeff += -data.time_driving_zone_depot(j);
-							}
-							else if (i > nb_zones && j < nb_zones) { // i == collection point, j == zone
-								const std::string& cp = data.collection_point_name(i - nb_zones - 1);
-								coeff += -data.time_driving_zone_collectionpoint(j, cp);
-							}
-							else if (i > nb_zones && j == nb_zones) { // i == collection point, j == depot
-								coeff += -data.time_driving_collectionpoint_depot(i - nb_zones - 1);
-							}
-
-							const size_t index = index_x_dvijk(d, v, i, j, k);
-							if (index >= nb_variables)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-							matind[nonzeroes] = index;
-							matval[nonzeroes] = coeff;
-							++nonzeroes;
-						}
-					}
+					builder.add_coefficient(_layout.x_dvijk(d, v, arc.i, arc.j, arc.k), -arc_time(data, arc.i, arc.j));
 				}
 
 				// -sum(m,k) tau_P_i*w_dvik
@@ -389,84 +318,34 @@ namespace IVM
 				{
 					for (int k = 0; k < nb_segments; ++k)
 					{
-						const size_t index = index_w_dvik(d, v, m, k);
-						if (index >= nb_variables)
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-						matind[nonzeroes] = index;
-						const std::string& waste_type = data.waste_type(0); // assume only one waste type
-						matval[nonzeroes] = -data.time_pickup(m, waste_type);
-						++nonzeroes;
-					}
-				}
-
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+						const size_t index = _layout.w_dvik(d, v, m, k);
 
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
+						builder.add_coefficient(index, -data.time_pickup(static_cast<size_t>(m), static_cast<size_t>(0))); // assume only one waste type
+					}
 				}
 
-				// change name of constraint
-				std::string conname = "c1_" + std::to_string(d + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c1_" + std::to_string(d + 1) + "_" + std::to_string(v + 1); };
+				builder.add_row(0, 'E', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 2: beta_dv <= T  forall d,v
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
 			{
-				++nb_constraints;
-
-				rhs[0] = data.max_driving_time(0); // assume one truck type
-				sense[0] = 'L';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// beta_qv
-				{
-					const size_t index = index_beta_dv(d, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
-				}
-
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+				builder.add_coefficient(_layout.beta_dv(d, v), 1);
 
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c2_" + std::to_string(d + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c2_" + std::to_string(d + 1) + "_" + std::to_string(v + 1); };
+				builder.add_row(data.max_driving_time(0), 'L', conname); // assume one truck type
 			}
 		}
+		builder.flush_rows();
 
 		// 3: w_dvik <= L sum(j) x_djik   forall t,q,v,i,k
+		_startindex_c3_dvik = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
@@ -475,75 +354,31 @@ namespace IVM
 				{
 					for (int k = 0; k < nb_segments; ++k)
 					{
-						++nb_constraints;
-
-						rhs[0] = 0;
-						sense[0] = 'L';
-						matbeg[0] = 0;
-
-						nonzeroes = 0;
-
 						// w_tqvik
-						{
-							const size_t index = index_w_dvik(d, v, m, k);
-							if (index >= nb_variables)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-							matind[nonzeroes] = index;
-							matval[nonzeroes] = 1;
-							++nonzeroes;
-						}
+						builder.add_coefficient(_layout.w_dvik(d, v, m, k), 1);
 
 						// - L_tq sum(j) x_qvjik (aankomen bij i)
 						for (int j = 0; j < nb_locations; ++j)
 						{
-							const size_t index = index_x_dvijk(d, v, j, m, k);
-							if (index >= nb_variables)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-							matind[nonzeroes] = index;
-							const std::string& waste_type = data.waste_type(0); // assume one waste type
-							matval[nonzeroes] = -data.capacity(0, waste_type); // assume one truck type
-							++nonzeroes;
-						}
-
-						if (nonzeroes >= maxnonzeroes)
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+							if (!_layout.x_dvijk.contains(d, j, m, k))
+								continue;
+							const size_t index = _layout.x_dvijk(d, v, j, m, k);
 
-						status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
+							builder.add_coefficient(index, -data.capacity(static_cast<size_t>(0), static_cast<size_t>(0))); // assume one truck type and one waste type
 						}
 
-						// change name of constraint
-						std::string conname = "c3_" + std::to_string(d + 1) + "_" + std::to_string(v + 1)
-							+ "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1);
-						status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-						}
+						auto conname = [&] { return "c3_" + std::to_string(d + 1) + "_" + std::to_string(v + 1)
+							+ "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1); };
+						builder.add_row(0, 'L', conname);
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 4. sum(d,v,k) w_dvik == alpha_i   forall i
 		for (int m = 0; m < nb_zones; ++m)
 		{
-			++nb_constraints;
-
-			const std::string& waste_type = data.waste_type(0); // assume one waste type
-			rhs[0] = data.demand(m, waste_type);
-
-			sense[0] = 'E';
-			matbeg[0] = 0;
-
-			nonzeroes = 0;
-
 			// sum(d,v,k) w_dvik
 			for (int d = 0; d < nb_days_total; ++d)
 			{
@@ -551,110 +386,47 @@ namespace IVM
 				{
 					for (int k = 0; k < nb_segments; ++k)
 					{
-						const size_t index = index_w_dvik(d, v, m, k);
-						if (index >= nb_variables)
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-						matind[nonzeroes] = index;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						builder.add_coefficient(_layout.w_dvik(d, v, m, k), 1);
 					}
 				}
 			}
 
-			if (nonzeroes >= maxnonzeroes)
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-			status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-			}
-
-			// change name of constraint
-			std::string conname = "c4_" + std::to_string(m + 1);
-			status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-			}
+			auto conname = [&] { return "c4_" + std::to_string(m + 1); };
+			builder.add_row(data.demand(static_cast<size_t>(m), static_cast<size_t>(0)), 'E', conname); // assume one waste type
 		}
+		builder.flush_rows();
 
 		// 5. sum(j) x_dv,depot,j,1 - y_dv == 0   forall d,v
+		_startindex_c5_dv = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
 			{
-				++nb_constraints;
-
-				rhs[0] = 0;
-				sense[0] = 'E';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// sum(j) x_dv,depot,j,1
 				for (int j = 0; j < nb_locations; ++j)
 				{
 					const int index_depot = nb_zones;
 					const int index_k = 0;
 
-					const size_t index = index_x_dvijk(d, v, index_depot, j, index_k);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
+					if (_layout.x_dvijk.contains(d, index_depot, j, index_k))
+						builder.add_coefficient(_layout.x_dvijk(d, v, index_depot, j, index_k), 1);
 				}
 
 				// y_dv
-				{
-					const int index = index_y_dv(d, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-				}
+				builder.add_coefficient(_layout.y_dv(d, v), -1);
 
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c5_" + std::to_string(d + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c5_" + std::to_string(d + 1) + "_" + std::to_string(v + 1); };
+				builder.add_row(0, 'E', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 6. sum(j,k) x_dvi,depot,k - y_dv == 0   forall d,v
+		_startindex_c6_dv = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
 			{
-				++nb_constraints;
-
-				rhs[0] = 0;
-				sense[0] = 'E';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// sum(j,k) x_dvi,depot,k
 				for (int i = 0; i < nb_locations; ++i)
 				{
@@ -662,163 +434,25 @@ namespace IVM
 					{
 						const int index_depot = nb_zones;
 
-						const size_t index = index_x_dvijk(d, v, i, index_depot, k);
-						if (index >= nb_variables)
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-						matind[nonzeroes] = index;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						if (_layout.x_dvijk.contains(d, i, index_depot, k))
+							builder.add_coefficient(_layout.x_dvijk(d, v, i, index_depot, k), 1);
 					}
 				}
 
 				// y_dv
-				{
-					const size_t index = index_y_dv(d, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
+				builder.add_coefficient(_layout.y_dv(d, v), -1);
 
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-				}
-
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c6_" + std::to_string(d + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c6_" + std::to_string(d + 1) + "_" + std::to_string(v + 1); };
+				builder.add_row(0, 'E', conname);
 			}
 		}
+		builder.flush_rows();
 
-		// 7. x_dvijk == 0   for zone-zone or dropoff-dropoff
-		for (int d = 0; d < nb_days_total; ++d)
-		{
-			for (int v = 0; v < nb_trucks; ++v)
-			{
-				for (int i = 0; i < nb_locations; ++i)
-				{
-					for (int j = 0; j < nb_locations; ++j)
-					{
-						for (int k = 0; k < nb_segments; ++k)
-						{
-							// forbidden combinations
-							if ((i < nb_zones && j < nb_zones)       // zone - zone
-								|| (i > nb_zones && j > nb_zones)    // dropoff - dropoff
-								|| (i == nb_zones && j == nb_zones)  // depot - depot
-								|| (i == nb_zones && j > nb_zones)   // depot - dropoff (dropoff-depot however is possible)
-								|| (i < nb_zones && j == nb_zones)   // zone - depot (always first to dropoff)
-								|| (i == nb_zones && k > 0)) // depot-zone if not first segment
-							{
-								++nb_constraints;
-
-								rhs[0] = 0;
-								sense[0] = 'E';
-								matbeg[0] = 0;
-
-								nonzeroes = 0;
-
-								// x_dvijk
-								{
-									const size_t index = index_x_dvijk(d, v, i, j, k);
-									if (index >= nb_variables)
-										throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-									matind[nonzeroes] = index;
-									matval[nonzeroes] = 1;
-									++nonzeroes;
-								}
-
-								if (nonzeroes >= maxnonzeroes)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-								status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-								if (status != 0)
-								{
-									CPXgeterrorstring(env, status, error_text);
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-								}
-
-								// change name of constraint
-								std::string conname = "c7_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1) + "_"
-									+ std::to_string(j + 1) + "_" + std::to_string(k + 1);
-								status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-								if (status != 0)
-								{
-									CPXgeterrorstring(env, status, error_text);
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-								}
-							}
-
-							// forbidden dropoffs at collection points
-							// hier niet van toepassing
-							/*if (j > nb_zones)
-							{
-								int index_cp = j - nb_zones - 1;
-								auto& truck_name = data.truck_type(0);
-								if ((truck_name == "truck_GFT" && !data.collection_point_waste_type_allowed(index_cp, "GFT"))
-									|| (truck_name == "truck_restafval" && !data.collection_point_waste_type_allowed(index_cp, "restafval")))
-								{
-									++nb_constraints;
-
-									rhs[0] = 0;
-									sense[0] = 'E';
-									matbeg[0] = 0;
-
-									nonzeroes = 0;
-
-									// x_qvijk
-									{
-										const size_t index = index_x_qvijk(q, v, i, j, k);
-										if (index >= nb_variables)
-											throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-										matind[nonzeroes] = index;
-										matval[nonzeroes] = 1;
-										++nonzeroes;
-									}
-
-									if (nonzeroes >= maxnonzeroes)
-										throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-									status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-									}
-
-									// change name of constraint
-									std::string conname = "c7_dropoffs_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1) + "_"
-										+ std::to_string(j + 1) + "_" + std::to_string(k + 1);
-									status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-									}
-								}
-							}*/
-						}
-					}
-				}
-			}
-		}
+		// 7. x_dvijk == 0   for zone-zone, dropoff-dropoff, ...
+		//    these arcs have no variable (see structural_arc())
 
 		// 8. sum(j) x_dvij,k+1 - sum(j) x_dvjik == 0   forall d,v,i!=depot,k
+		_rowindex_c8_dvik.assign(nb_days_total * nb_trucks * nb_locations * nb_segments, -1);
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
@@ -829,233 +463,103 @@ namespace IVM
 					{
 						for (int k = 0; k < nb_segments - 1; ++k)
 						{
-							++nb_constraints;
-
-							rhs[0] = 0;
-							sense[0] = 'E';
-							matbeg[0] = 0;
-
-							nonzeroes = 0;
+							bool empty = true;
 
 							// sum(j) x_dvij,k+1
 							for (int j = 0; j < nb_locations; ++j)
 							{
-								const size_t index = index_x_dvijk(d, v, i, j, k + 1);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = 1;
-								++nonzeroes;
+								if (_layout.x_dvijk.contains(d, i, j, k + 1))
+								{
+									builder.add_coefficient(_layout.x_dvijk(d, v, i, j, k + 1), 1);
+									empty = false;
+								}
 							}
 
 							// sum(j) x_dvjik
 							for (int j = 0; j < nb_locations; ++j)
 							{
-								const size_t index = index_x_dvijk(d, v, j, i, k);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = -1;
-								++nonzeroes;
+								if (_layout.x_dvijk.contains(d, j, i, k))
+								{
+									builder.add_coefficient(_layout.x_dvijk(d, v, j, i, k), -1);
+									empty = false;
+								}
 							}
 
-							if (nonzeroes >= maxnonzeroes)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+							if (empty)
+								continue;
 
-							status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-							}
-
-							// change name of constraint
-							std::string conname = "c8_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1) + "_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-							}
+							_rowindex_c8_dvik[((d * nb_trucks + v) * nb_locations + i) * nb_segments + k] = builder.nb_rows();
+							auto conname = [&] { return "c8_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1) + "_" + std::to_string(k + 1); };
+							builder.add_row(0, 'E', conname);
 						}
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 9. sum(i,j) x_dvijk <= 1   forall d,v,k
+		_startindex_c9_dvk = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
 				for (int k = 0; k < _max_nb_segments; ++k)
 				{
-					++nb_constraints;
-
-					rhs[0] = 1;
-					sense[0] = 'L';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// sum(i,j) x_qvijk
 					for (int i = 0; i < nb_locations; ++i)
 					{
 						for (int j = 0; j < nb_locations; ++j)
 						{
-							const size_t index = index_x_dvijk(d, v, i, j, k);
-							if (index >= nb_variables)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-							matind[nonzeroes] = index;
-							matval[nonzeroes] = 1;
-							++nonzeroes;
+							if (_layout.x_dvijk.contains(d, i, j, k))
+								builder.add_coefficient(_layout.x_dvijk(d, v, i, j, k), 1);
 						}
 					}
 
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
-
-					// change name of constraint
-					std::string conname = "c9_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(k + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c9_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(k + 1); };
+					builder.add_row(1, 'L', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 10. x_dvijk - y_dv <= 0   forall d,v,i,j,k
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			for (int v = 0; v < nb_trucks; ++v)
 			{
-				for (int i = 0; i < nb_locations; ++i)
+				for (auto&& arc : _layout.x_dvijk.arcs(d))
 				{
-					for (int j = 0; j < nb_locations; ++j)
-					{
-						for (int k = 0; k < nb_segments; ++k)
-						{
-							++nb_constraints;
+					// x_qvijk
+					builder.add_coefficient(_layout.x_dvijk(d, v, arc.i, arc.j, arc.k), 1);
 
-							rhs[0] = 0;
-							sense[0] = 'L';
-							matbeg[0] = 0;
+					// - y_qv
+					builder.add_coefficient(_layout.y_dv(d, v), -1);
 
-							nonzeroes = 0;
-
-							// x_qvijk
-							{
-								const size_t index = index_x_dvijk(d, v, i, j, k);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = 1;
-								++nonzeroes;
-							}
-
-							// - y_qv
-							{
-								const size_t index = index_y_dv(d, v);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = -1;
-								++nonzeroes;
-							}
-
-							if (nonzeroes >= maxnonzeroes)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-							status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-							}
-
-							// change name of constraint
-							std::string conname = "c10_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1)
-								+ "_" + std::to_string(j + 1) + "_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-							}
-						}
-					}
+					auto conname = [&] { return "c10_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(arc.i + 1)
+						+ "_" + std::to_string(arc.j + 1) + "_" + std::to_string(arc.k + 1); };
+					builder.add_row(0, 'L', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 11. sum(v) y_dv - z <= 0   forall d
 		for (int d = 0; d < nb_days_total; ++d)
 		{
-			++nb_constraints;
-
-			rhs[0] = 0;
-			sense[0] = 'L';
-			matbeg[0] = 0;
-
-			nonzeroes = 0;
-
 			// y_dv 
 			for(int v = 0; v < nb_trucks; ++v)
 			{
-				const size_t index = index_y_dv(d, v);
-				if (index >= nb_variables)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-				matind[nonzeroes] = index;
-				matval[nonzeroes] = 1;
-				++nonzeroes;
+				builder.add_coefficient(_layout.y_dv(d, v), 1);
 			}
 
 			// - z
-			{
-				const size_t index = startindex_z;
-				if (index >= nb_variables)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
+			builder.add_coefficient(_layout.z(), -1);
 
-				matind[nonzeroes] = index;
-				matval[nonzeroes] = -1;
-				++nonzeroes;
-			}
-
-			if (nonzeroes >= maxnonzeroes)
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-			status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-			}
-
-			// change name of constraint
-			std::string conname = "c11_" + std::to_string(d + 1);
-			status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-			}
+			auto conname = [&] { return "c11_" + std::to_string(d + 1); };
+			builder.add_row(0, 'L', conname);
 		}
+		builder.flush_rows();
 
 		// 12. x_dvijk - ksi_di <= 0   forall d,v,i,j,k
 		for (int d = 0; d < nb_days_total; ++d)
@@ -1068,103 +572,38 @@ namespace IVM
 					{
 						for (int k = 0; k < nb_segments; ++k)
 						{
-							++nb_constraints;
-
-							rhs[0] = 0;
-							sense[0] = 'L';
-							matbeg[0] = 0;
-
-							nonzeroes = 0;
+							if (!_layout.x_dvijk.contains(d, i, j, k))
+								continue;
 
 							// x_dvijk
-							{
-								const size_t index = index_x_dvijk(d, v, i, j, k);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = 1;
-								++nonzeroes;
-							}
+							builder.add_coefficient(_layout.x_dvijk(d, v, i, j, k), 1);
 
 							// - ksi_di
-							{
-								const size_t index = index_ksi_di(d, i);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = -1;
-								++nonzeroes;
-							}
-
-							if (nonzeroes >= maxnonzeroes)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+							builder.add_coefficient(_layout.ksi_di(d, i), -1);
 
-							status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-							}
-
-							// change name of constraint
-							std::string conname = "c12_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1)
-								+ "_" + std::to_string(j + 1) + "_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-							}
+							auto conname = [&] { return "c12_" + std::to_string(d + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1)
+								+ "_" + std::to_string(j + 1) + "_" + std::to_string(k + 1); };
+							builder.add_row(0, 'L', conname);
 						}
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 13. sum(d) ksi_di <= max_visits   forall i (zones)
 		for (int i = 0; i < nb_zones; ++i)
 		{
-			++nb_constraints;
-
-			rhs[0] = max_visits;
-			sense[0] = 'L'; 
-			matbeg[0] = 0;
-
-			nonzeroes = 0;
-
 			// sum(d) ksi_di
 			for(int d = 0; d < nb_days_total; ++d)
 			{
-				const size_t index = index_ksi_di(d, i);
-				if (index >= nb_variables)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-				matind[nonzeroes] = index;
-				matval[nonzeroes] = 1;
-				++nonzeroes;
+				builder.add_coefficient(_layout.ksi_di(d, i), 1);
 			}
 
-			if (nonzeroes >= maxnonzeroes)
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-			status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-			}
-
-			// change name of constraint
-			std::string conname = "c13_" + std::to_string(i + 1);
-			status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-			if (status != 0)
-			{
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-			}
+			auto conname = [&] { return "c13_" + std::to_string(i + 1); };
+			builder.add_row(max_visits, 'L', conname);
 		}
+		builder.flush_rows();
 
 		// 14. ksi_di = 0   on forbidden days d
 		for (int d = 0; d < nb_days_total; ++d)
@@ -1174,106 +613,101 @@ namespace IVM
 				int day = d % 5; // day of week, week does not matter
 				if (data.zone_forbidden_day(i, day))
 				{
-					++nb_constraints;
-
-					rhs[0] = 0;
-					sense[0] = 'E';
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// ksi_di
-					const size_t index = index_ksi_di(d, i);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
+					builder.add_coefficient(_layout.ksi_di(d, i), 1);
 
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
-
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+					auto conname = [&] { return "c14_" + std::to_string(d + 1) + "_" + std::to_string(i + 1); };
+					builder.add_row(0, 'E', conname);
+				}
+			}
+		}
+		builder.flush_rows();
 
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
+		// Symmetry breaking (optional): the trucks are identical
+		// 1. y_d,v+1 - y_dv <= 0   forall d,v: the used trucks come first
+		if (_symmetry_breaking >= SYMMETRY_ORDER_TRUCKS)
+		{
+			for (int d = 0; d < nb_days_total; ++d)
+			{
+				for (int v = 0; v < nb_trucks - 1; ++v) // niet laatste
+				{
+					// y_d,v+1
+					builder.add_coefficient(_layout.y_dv(d, v + 1), 1);
 
-					// change name of constraint
-					std::string conname = "c14_" + std::to_string(d + 1) + "_" + std::to_string(i + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					// -y_dv
+					builder.add_coefficient(_layout.y_dv(d, v), -1);
+
+					auto conname = [&] { return "symmetry_breaking_c1_" + std::to_string(d + 1) + "_" + std::to_string(v + 1); };
+					builder.add_row(0, 'L', conname);
 				}
 			}
+			builder.flush_rows();
 		}
 
-		// Symmetry breaking
-		/*for (int d = 0; d < nb_days_total; ++d)
+		// 2. beta_d,v+1 - beta_dv <= 0   forall d,v: the used trucks are sorted by route duration (beta_dv == 0 for an unused truck)
+		if (_symmetry_breaking >= SYMMETRY_ORDER_DURATION)
 		{
-			for (int v = 0; v < nb_trucks - 1; ++v) // niet laatste
+			for (int d = 0; d < nb_days_total; ++d)
 			{
-				++nb_constraints;
-
-				rhs[0] = 0;
-				sense[0] = 'L';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
-				// y_d,v+1
+				for (int v = 0; v < nb_trucks - 1; ++v) // niet laatste
 				{
-					const size_t index = index_y_dv(d, v + 1);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
+					// beta_d,v+1
+					builder.add_coefficient(_layout.beta_dv(d, v + 1), 1);
+
+					// -beta_dv
+					builder.add_coefficient(_layout.beta_dv(d, v), -1);
 
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
+					auto conname = [&] { return "symmetry_breaking_c2_" + std::to_string(d + 1) + "_" + std::to_string(v + 1); };
+					builder.add_row(0, 'L', conname);
 				}
+			}
+			builder.flush_rows();
+		}
 
-				// -y_dv
+		// 3. sum(v,i,k) w_d2,vik - sum(v,i,k) w_d1,vik <= 0   for consecutive days d1 < d2 of the same class of interchangeable days:
+		//    the days of a class are sorted by the total amount picked up
+		if (_day_symmetry_breaking)
+		{
+			const std::vector<std::vector<size_t>> day_classes = day_symmetry_classes(data);
+			size_t nb_ordering_constraints = 0;
+			for (auto&& day_class : day_classes)
+			{
+				for (size_t n = 0; n + 1 < day_class.size(); ++n)
 				{
-					const size_t index = index_y_dv(d, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
+					const size_t d1 = day_class[n];
+					const size_t d2 = day_class[n + 1];
 
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-				}
+					// w_d2,vik
+					for (size_t index : _layout.w_dvik.slice(d2))
+						builder.add_coefficient(index, 1);
 
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
+					// - w_d1,vik
+					for (size_t index : _layout.w_dvik.slice(d1))
+						builder.add_coefficient(index, -1);
 
-				// change name of constraint
-				std::string conname = "symmetry_breaking_c1_" + std::to_string(d + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
+					auto conname = [&] { return "symmetry_breaking_c3_" + std::to_string(d1 + 1) + "_" + std::to_string(d2 + 1); };
+					builder.add_row(0, 'L', conname);
+					++nb_ordering_constraints;
 				}
 			}
+			builder.flush_rows();
+
+			std::cout << "\nDay symmetry: " << day_classes.size() << " classes of interchangeable days, " << nb_ordering_constraints << " ordering constraints";
 		}
-		*/
 
+		builder.print_statistics();
 
-		// write to file
-		status = CPXwriteprob(env, problem, "IP_model_integrated.lp", NULL);
-		if (status != 0)
+
+		// write to file (only on request, as compressed SAV file)
+		if (_export_model)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_integrated::build_problem(). \nCouldn't write problem to lp-file. \nReason: " + std::string(error_text));
+			std::string filename = "IP_model_integrated.sav.gz";
+			status = CPXwriteprob(env, problem, filename.c_str(), NULL);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_integrated::build_problem(). \nCouldn't write problem to sav-file. \nReason: " + std::string(error_text));
+			}
 		}
 	}
 
@@ -1285,13 +719,6 @@ namespace IVM
 		std::unique_ptr<double[]> solution_problem;
 		double objval;
 
-		/*status = CPXreadcopyprob(env, problem, "IP_model_integrated.lp", NULL); /// Dit werkt wel, maar probleem rechtstreeks geeft error
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't read problem from lp-file. \nReason: " + std::string(error_text));
-		}*/
-
 		// Set allowed computation time
 		status = CPXsetdblparam(env, CPXPARAM_TimeLimit, _max_computation_time);
 		if (status != 0)
@@ -1316,6 +743,17 @@ namespace IVM
 			throw std::runtime_error("Error in function IP_model_allocation::solve_problem(). \nCouldn't set search strategy. \nReason: " + std::string(error_text));
 		}
 
+		// Symmetry breaking by CPLEX (most aggressive level, includes orbital fixing)
+		if (_symmetry_breaking >= SYMMETRY_ORDER_AND_CPLEX)
+		{
+			status = CPXsetintparam(env, CPXPARAM_Preprocessing_Symmetry, 5);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_integrated::solve_problem(). \nCouldn't set symmetry breaking. \nReason: " + std::string(error_text));
+			}
+		}
+
 		// Assign memory for solution
 		const int numvar = CPXgetnumcols(env, problem);
 		solution_problem = std::make_unique<double[]>(numvar);
@@ -1361,33 +799,6 @@ namespace IVM
 				const size_t nb_collection_points = data.nb_collection_points();
 				const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
 				const size_t max_visits = _max_visits;
- 
-				const int startindex_x_dvijk = 0;
-				const int startindex_w_dvik = startindex_x_dvijk + nb_days_total * nb_trucks * nb_locations * nb_locations * nb_segments;
-				const int startindex_y_dv = startindex_w_dvik + nb_days_total * nb_trucks * nb_zones * nb_segments;
-				const int startindex_beta_dv = startindex_y_dv + nb_days_total * nb_trucks;
-				const int startindex_z = startindex_beta_dv + nb_days_total * nb_trucks;
-				const int startindex_ksi_di = startindex_z + 1;
-
-
-				// lambdas to get variable indices
-				auto index_x_dvijk = [startindex_x_dvijk, nb_trucks, nb_locations, nb_segments](int d, int v, int i, int j, int k) -> int {
-					return startindex_x_dvijk + d * nb_trucks * nb_locations * nb_locations * nb_segments + v * nb_locations * nb_locations * nb_segments
-						+ i * nb_locations * nb_segments + j * nb_segments + k;
-					};
-				auto index_w_dvik = [startindex_w_dvik, nb_trucks, nb_zones, nb_segments](int d, int v, int i_zone, int k) -> int {
-					return startindex_w_dvik + d * nb_trucks * nb_zones * nb_segments + v * nb_zones * nb_segments + i_zone * nb_segments + k;
-					};
-				auto index_y_dv = [startindex_y_dv, nb_trucks](int d, int v) -> int {
-					return startindex_y_dv + d * nb_trucks + v;
-					};
-				auto index_beta_dv = [startindex_beta_dv, nb_trucks](int d, int v) -> int {
-					return startindex_beta_dv + d * nb_trucks + v;
-					};
-				auto index_ksi_di = [startindex_ksi_di, nb_zones](int d, int m) -> int {
-					return startindex_ksi_di + d * nb_zones + m;
-					};
-				
 
 
 				// Solution to file
@@ -1418,15 +829,15 @@ namespace IVM
 						// calculate routes
 						for (int d = 0; d < nb_days_total; ++d) {
 							for (int v = 0; v < nb_trucks; ++v) {
-								if(solution_problem[index_y_dv(d,v)] > 0) {
+								if(solution_problem[_layout.y_dv(d,v)] > 0) {
 									// route
 									Route newroute;
 									newroute.day = d;
-									newroute.hours = solution_problem[index_beta_dv(d, v)];
+									newroute.hours = solution_problem[_layout.beta_dv(d, v)];
 
 									for (int m = 0; m < nb_zones; ++m) {
 										for (int k = 0; k < nb_segments; ++k) {
-											double wval = solution_problem[index_w_dvik(d, v, m, k)];
+											double wval = solution_problem[_layout.w_dvik(d, v, m, k)];
 											if (wval > 0.001) {
 												int wvalkg = static_cast<int>(wval * 1000 + 0.001);
 												newroute.amounts.push_back(wvalkg);
@@ -1437,7 +848,9 @@ namespace IVM
 									for (int k = 0; k < nb_segments; ++k) {
 										for (int i = 0; i < nb_locations; ++i) {
 											for (int j = 0; j < nb_locations; ++j) {
-												int xval = static_cast<int>(solution_problem[index_x_dvijk(d, v, i, j, k)] + 0.001);
+												if (!_layout.x_dvijk.contains(d, i, j, k))
+													continue;
+												int xval = static_cast<int>(solution_problem[_layout.x_dvijk(d, v, i, j, k)] + 0.001);
 												if (xval > 0) {
 													std::string destination;
 													if (j < nb_zones)
@@ -1473,7 +886,7 @@ namespace IVM
 
 						// costs and trucks per day
 						solfile << "\n\n\nKosten: " << objval;
-						solfile << "\nz = " << solution_problem[startindex_z];
+						solfile << "\nz = " << solution_problem[_layout.z()];
 						solfile << "\n\nDag\tTrucks";
 						for (int d = 0; d < nb_days_total; ++d) {
 							int trucksday = 0;
@@ -1510,7 +923,7 @@ namespace IVM
 						for (int m = 0; m < nb_zones; ++m) {
 							solfile << "\n" << data.zone_name(m) << "\t";
 							for (int d = 0; d < nb_days_total; ++d) {
-								int ksi_di = static_cast<int>(solution_problem[index_ksi_di(d, m)] + 0.001);
+								int ksi_di = static_cast<int>(solution_problem[_layout.ksi_di(d, m)] + 0.001);
 								if (ksi_di > 0)
 									solfile << "gft";
 								solfile << "\t";
@@ -1533,6 +946,94 @@ namespace IVM
 
 	}
 
+	void IP_model_integrated::price_sparsified_arcs(const Instance& data)
+	{
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = 0;
+
+		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
+		const size_t nb_trucks = _max_nb_trucks;
+		const size_t nb_segments = _max_nb_segments;
+		const size_t nb_zones = data.nb_zones();
+		const size_t nb_locations = nb_zones + 1 + data.nb_collection_points();
+		const int index_depot = static_cast<int>(nb_zones);
+
+		// Duals of the LP relaxation of the sparse model
+		CPXLPptr relaxation = CPXcloneprob(env, problem, &status);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::price_sparsified_arcs(). \nCouldn't copy problem. \nReason: " + std::string(error_text));
+		}
+
+		status = CPXchgprobtype(env, relaxation, CPXPROB_LP);
+		if (status == 0)
+			status = CPXlpopt(env, relaxation);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			CPXfreeprob(env, &relaxation);
+			throw std::runtime_error("Error in function IP_model_integrated::price_sparsified_arcs(). \nCouldn't solve LP relaxation. \nReason: " + std::string(error_text));
+		}
+
+		std::vector<double> pi(CPXgetnumrows(env, relaxation), 0.0);
+		status = CPXgetpi(env, relaxation, pi.data(), 0, static_cast<int>(pi.size()) - 1);
+		CPXfreeprob(env, &relaxation);
+		if (status != 0)
+		{
+			std::cout << "\nNo duals for the LP relaxation, the left out arcs are not priced";
+			return;
+		}
+
+		// Reduced cost of x_dvijk: 0 - sum(rows) pi_row * a_row,dvijk (rows of constraints 1, 3, 5, 6, 8 and 9;
+		// constraints 10 and 12 and rows of constraint 8 that were left out would be new rows, with dual 0)
+		const double capacity = data.capacity(static_cast<size_t>(0), static_cast<size_t>(0)); // assume one truck type and one waste type
+		size_t nb_priced = 0, nb_improving = 0;
+		double min_reduced_cost = 0;
+		for (auto&& arc : _sparsified_arcs)
+		{
+			const double time = arc_time(data, arc.i, arc.j);
+			for (size_t d = 0; d < nb_days_total; ++d)
+			{
+				for (size_t v = 0; v < nb_trucks; ++v)
+				{
+					const size_t dv = d * nb_trucks + v;
+					double reduced_cost = pi[_startindex_c1_dv + dv] * time;
+
+					if (arc.j < index_depot) // c3: arriving at zone j
+						reduced_cost += pi[_startindex_c3_dvik + (dv * nb_zones + arc.j) * nb_segments + arc.k] * capacity;
+					if (arc.i == index_depot && arc.k == 0)
+						reduced_cost -= pi[_startindex_c5_dv + dv];
+					if (arc.j == index_depot)
+						reduced_cost -= pi[_startindex_c6_dv + dv];
+					if (arc.i != index_depot && arc.k > 0) // c8 for (i,k-1): leaving i
+					{
+						const int row = _rowindex_c8_dvik[(dv * nb_locations + arc.i) * nb_segments + arc.k - 1];
+						if (row >= 0)
+							reduced_cost -= pi[row];
+					}
+					if (arc.j != index_depot && arc.k < nb_segments - 1) // c8 for (j,k): arriving at j
+					{
+						const int row = _rowindex_c8_dvik[(dv * nb_locations + arc.j) * nb_segments + arc.k];
+						if (row >= 0)
+							reduced_cost += pi[row];
+					}
+					reduced_cost -= pi[_startindex_c9_dvk + dv * nb_segments + arc.k];
+
+					++nb_priced;
+					if (reduced_cost < -1e-6)
+						++nb_improving;
+					min_reduced_cost = std::min(min_reduced_cost, reduced_cost);
+				}
+			}
+		}
+
+		std::cout << "\nPricing of the arcs left out by sparsification: " << nb_improving << " of " << nb_priced
+			<< " arc variables have a negative reduced cost (minimum " << min_reduced_cost << ")";
+		if (nb_improving > 0)
+			std::cout << "\nWarning: the sparse model may have missed better routes";
+	}
+
 	void IP_model_integrated::clear_cplex()
 	{
 		int status = 0;
@@ -1560,9 +1061,70 @@ namespace IVM
 		initialize_cplex();
 		build_problem(data);
 		solve_problem(data);
+		if (_arc_reprice)
+			price_sparsified_arcs(data);
 		clear_cplex();
 	}
 
+	void IP_model_integrated::benchmark_build(const Instance& data)
+	{
+		std::cout << "\n\nBenchmark building the integrated model";
+
+		// reference: one call to CPLEX per variable and constraint, then in bulk
+		double build_time[2];
+		for (int batched = 0; batched < 2; ++batched)
+		{
+			_batched_build = (batched == 1);
+
+			initialize_cplex();
+			auto start_time = std::chrono::system_clock::now();
+			build_problem(data);
+			std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+			build_time[batched] = elapsed_time.count();
+			clear_cplex();
+		}
+		_batched_build = true;
+
+		std::cout << "\n\nBuild time one call per variable/constraint (s): " << build_time[0];
+		std::cout << "\nBuild time in bulk (s): " << build_time[1];
+		std::cout << "\nSpeedup: " << build_time[0] / build_time[1];
+	}
+
+	void IP_model_integrated::benchmark_symmetry_breaking(const Instance& data)
+	{
+		std::cout << "\n\nBenchmark symmetry breaking for the integrated model";
+
+		const int symmetry_breaking = _symmetry_breaking;
+		std::ostringstream table;
+		table << "\n\nSymmetry breaking\tStatus\tObjective value\tGap\tNodes\tTime (s)";
+		for (int level = SYMMETRY_NONE; level <= SYMMETRY_ORDER_AND_CPLEX; ++level)
+		{
+			_symmetry_breaking = level;
+
+			initialize_cplex();
+			build_problem(data);
+			auto start_time = std::chrono::system_clock::now();
+			solve_problem(data);
+			std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+
+			char solstat_text[CPXMESSAGEBUFSIZE];
+			if (CPXgetstatstring(env, CPXgetstat(env, problem), solstat_text) == nullptr)
+				std::strcpy(solstat_text, "unknown");
+			table << "\n" << level << "\t" << solstat_text << "\t";
+			double objval = 0, gap = 0;
+			if (CPXgetobjval(env, problem, &objval) == 0 && CPXgetmiprelgap(env, problem, &gap) == 0)
+				table << objval << "\t" << gap;
+			else
+				table << "-\t-";
+			table << "\t" << CPXgetnodecnt(env, problem) << "\t" << elapsed_time.count();
+
+			clear_cplex();
+		}
+		_symmetry_breaking = symmetry_breaking;
+
+		std::cout << table.str();
+	}
+
 	///////////////////////////////////////////////////////////////////////////////////////////////
 
 	void IP_model_integrated::run_fix_and_optimize(const Instance& data)
@@ -1571,24 +1133,23 @@ namespace IVM
 		build_problem(data);
 
 		fix_and_optimize(data);
+		if (_arc_reprice)
+			price_sparsified_arcs(data);
 
 		clear_cplex();
 	}
 
 	void IP_model_integrated::fix_and_optimize(const Instance& data)
 	{
-		// Data
-		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
-		const size_t nb_trucks = _max_nb_trucks;
-		const size_t nb_segments = _max_nb_segments;
-		const size_t nb_zones = data.nb_zones();
-		const size_t nb_collection_points = data.nb_collection_points();
-		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
-		const size_t max_visits = _max_visits;
-
-		std::random_device randdev;
-		std::seed_seq seedseq{ randdev(),randdev(),randdev(),randdev(),randdev(),randdev(),randdev() };
-		std::mt19937_64 engine(seedseq);
+		// Seed (random unless set, printed so that a run can be repeated)
+		uint64_t seed = _fao_seed;
+		if (seed == 0)
+		{
+			std::random_device randdev;
+			seed = (static_cast<uint64_t>(randdev()) << 32) | randdev();
+		}
+		std::cout << "\nFix-and-optimize seed: " << seed;
+		std::mt19937_64 engine(seed);
 
 		std::chrono::duration<double, std::ratio<1, 1>> elapsed_time;
 		auto start_time = std::chrono::system_clock::now();
@@ -1599,212 +1160,543 @@ namespace IVM
 		// Simply use CPLEX to find initial solution
 		double best_objval = fao_initial_solution_cplex();
 		std::cout << "\nInitial objective value: " << best_objval;
-		
 
+		// Original bounds (the variables are fixed by changing their bounds)
+		const int numvar = CPXgetnumcols(env, problem);
+		_fao_lb.resize(numvar);
+		_fao_ub.resize(numvar);
+		int status = CPXgetlb(env, problem, _fao_lb.data(), 0, numvar - 1);
+		if (status == 0)
+			status = CPXgetub(env, problem, _fao_ub.data(), 0, numvar - 1);
+		if (status != 0)
+		{
+			char error_text[CPXMESSAGEBUFSIZE];
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::fix_and_optimize(). \nCouldn't get bounds variables. \nReason: " + std::string(error_text));
+		}
+		_fao_fixing_time = 0;
+
+		if (_fao_lp_guided)
+			fao_solve_lp_relaxation();
+
+		fao_set_parameters();
+
+
+
+		// Search neighborhoods until time out (by one or by several workers at the same time)
+		Fao_Search_State state;
+		state.objective_value = best_objval;
+		state.solution = _fao_best_solution_cplex;
+		auto start_time_neighborhoods = std::chrono::system_clock::now();
+
+		if (_fao_nb_workers <= 1)
+		{
+			fao_worker(data, state, start_time, engine());
+		}
+		else
+		{
+			// Worker 0 searches with the problem that is already built, every other worker has its own CPLEX environment with a copy of the problem
+			// The cores are divided over the workers, so that CPLEX never uses more threads than there are cores
+			size_t nb_cores = std::thread::hardware_concurrency();
+			if (nb_cores == 0)
+				nb_cores = _fao_nb_workers;
+			const size_t nb_workers = std::min(_fao_nb_workers, nb_cores);
+			const int nb_threads_per_worker = static_cast<int>(std::max<size_t>(1, nb_cores / nb_workers));
+
+			std::cout << "\n\nFix-and-optimize with " << nb_workers << " workers (" << nb_threads_per_worker << " threads per worker)";
+
+			// The copies are made before the workers start (worker 0 changes this model)
+			std::vector<IP_model_integrated> copies;
+			copies.reserve(nb_workers - 1);
+			for (size_t w = 1; w < nb_workers; ++w)
+			{
+				copies.emplace_back(*this); // same settings and bounds, own CPLEX environment
+				IP_model_integrated& copy = copies.back();
+				copy.env = nullptr;
+				copy.problem = nullptr;
+				copy._nb_threads = nb_threads_per_worker;
+				copy._export_model = false;
+				copy._fao_fixing_time = 0;
+			}
+
+			const int nb_threads = _nb_threads;
+			_nb_threads = nb_threads_per_worker;
+			status = CPXsetintparam(env, CPXPARAM_Threads, _nb_threads);
+			if (status != 0)
+			{
+				char error_text[CPXMESSAGEBUFSIZE];
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_integrated::fix_and_optimize(). \nCouldn't change param Threads. \nReason: " + std::string(error_text));
+			}
+
+			std::vector<std::exception_ptr> errors(nb_workers);
+			std::vector<std::thread> workers;
+			for (size_t w = 0; w < nb_workers; ++w)
+			{
+				IP_model_integrated* worker = (w == 0) ? this : &copies[w - 1];
+				const uint64_t seed = engine(); // every worker its own sequence of neighborhoods
+				workers.emplace_back([worker, &data, &state, &errors, start_time, seed, w]()
+					{
+						try
+						{
+							try
+							{
+								if (w > 0)
+								{
+									worker->initialize_cplex();
+									worker->build_problem(data);
+									worker->fao_set_parameters();
+								}
+								worker->fao_worker(data, state, start_time, seed);
+							}
+							catch (...)
+							{
+								// free the CPLEX objects of the failed worker (errors while freeing are ignored, the first error is reported)
+								if (worker->problem != nullptr)
+									CPXfreeprob(worker->env, &worker->problem);
+								if (worker->env != nullptr)
+									CPXcloseCPLEX(&worker->env);
+								throw;
+							}
+							if (w > 0)
+								worker->clear_cplex();
+						}
+						catch (...)
+						{
+							errors[w] = std::current_exception();
+							state.stop = true; // the other workers stop after their current neighborhood
+						}
+					});
+			}
+			for (auto&& worker : workers)
+				worker.join();
+			copies.clear(); // the bounds and solutions of the other workers are no longer needed
+
+			// Back to the threads of the model (for the pricing of the arcs left out by sparsification)
+			_nb_threads = nb_threads;
+			if (env != nullptr)
+				CPXsetintparam(env, CPXPARAM_Threads, _nb_threads);
+
+			for (auto&& error : errors)
+			{
+				if (error)
+				{
+					// Keep the best solution found so far
+					_fao_best_solution_cplex = state.solution;
+					_objective_value = state.objective_value;
+					std::cout << "\n\nFix-and-optimize stopped by an error, best objective value: " << _objective_value;
+					fao_write_solution_file(data);
+					std::rethrow_exception(error);
+				}
+			}
+		}
+
+		best_objval = state.objective_value;
+		_fao_best_solution_cplex = state.solution;
+
+		std::cout << "\n\nFixe-and-optimize: time limit reached ... ";
+		std::cout << "\nBest objective value: " << best_objval;
+		_objective_value = best_objval;
+
+		// Iteration rate
+		elapsed_time = std::chrono::system_clock::now() - start_time_neighborhoods;
+		std::cout << "\nNeighborhoods searched: " << state.nb_neighborhoods;
+		std::cout << "\nNeighborhoods per minute: " << 60.0 * state.nb_neighborhoods / std::max(elapsed_time.count(), 1e-6);
+		std::cout << "\nTime fixing and releasing variables (s): " << state.fixing_time;
+
+		// store solution
+		fao_write_solution_file(data);
+	}
+
+	void IP_model_integrated::fao_solve_lp_relaxation()
+	{
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = 0;
+		auto start_time = std::chrono::system_clock::now();
+
+		// Copy of the problem without integrality constraints
+		CPXLPptr relaxation = CPXcloneprob(env, problem, &status);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_solve_lp_relaxation(). \nCouldn't copy problem. \nReason: " + std::string(error_text));
+		}
+
+		status = CPXchgprobtype(env, relaxation, CPXPROB_LP);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			CPXfreeprob(env, &relaxation);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_solve_lp_relaxation(). \nCouldn't change problem type. \nReason: " + std::string(error_text));
+		}
+
+		status = CPXlpopt(env, relaxation);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			CPXfreeprob(env, &relaxation);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_solve_lp_relaxation(). \nCPXlpopt failed. \nReason: " + std::string(error_text));
+		}
+
+		const int numvar = CPXgetnumcols(env, relaxation);
+		_fao_lp_solution.assign(numvar, 0.0);
+		_fao_lp_reduced_costs.assign(numvar, 0.0);
+		_fao_objective_coefficients.assign(numvar, 0.0);
+
+		int solstat = 0;
+		double objval = 0;
+		status = CPXsolution(env, relaxation, &solstat, &objval, _fao_lp_solution.data(), NULL, NULL, _fao_lp_reduced_costs.data());
+		if (status == 0)
+			status = CPXgetobj(env, relaxation, _fao_objective_coefficients.data(), 0, numvar - 1);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			CPXfreeprob(env, &relaxation);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_solve_lp_relaxation(). \nCPXsolution failed. \nReason: " + std::string(error_text));
+		}
+
+		status = CPXfreeprob(env, &relaxation);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_solve_lp_relaxation(). \nCouldn't free problem. \nReason: " + std::string(error_text));
+		}
+
+		std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+		std::cout << "\nLP relaxation: objective value " << objval << " (" << elapsed_time.count() << " s)";
+	}
+
+	std::vector<double> IP_model_integrated::fao_guided_scores(const Instance& data, int neighborhood) const
+	{
+		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
+		const size_t nb_trucks = _max_nb_trucks;
+		const size_t nb_segments = _max_nb_segments;
+		const size_t nb_zones = data.nb_zones();
+
+		size_t nb_elements = nb_zones;
+		if (neighborhood == FAO_DAYS)
+			nb_elements = nb_days_total;
+		else if (neighborhood == FAO_VEHICLES)
+			nb_elements = nb_trucks;
+
+		std::vector<double> fractionality(nb_elements, 0.0);
+		std::vector<double> difference(nb_elements, 0.0);
+		std::vector<double> reduced_cost(nb_elements, 0.0);
+		std::vector<double> driving_cost(nb_elements, 0.0);
+
+		// binary variable ksi_di or y_dv that belongs to an element
+		auto add_binary = [&](size_t element, size_t index)
+		{
+			const double lp = _fao_lp_solution[index];
+			const double best = _fao_best_solution_cplex[index];
+			fractionality[element] += std::min(lp, 1.0 - lp);
+			difference[element] += std::abs(lp - best);
+
+			// estimated gain of changing the value in the best solution (reduced cost < 0: better at 1, > 0: better at 0)
+			const double dj = _fao_lp_reduced_costs[index];
+			reduced_cost[element] += (best < 0.5) ? std::max(0.0, -dj) : std::max(0.0, dj);
+		};
+
+		for (size_t d = 0; d < nb_days_total; ++d)
+		{
+			for (size_t v = 0; v < nb_trucks; ++v)
+			{
+				const size_t index_beta = _layout.beta_dv(d, v);
+				const double cost_route = _fao_objective_coefficients[index_beta] * _fao_best_solution_cplex[index_beta];
+
+				if (neighborhood == FAO_DAYS)
+				{
+					add_binary(d, _layout.y_dv(d, v));
+					driving_cost[d] += cost_route;
+				}
+				else if (neighborhood == FAO_VEHICLES)
+				{
+					add_binary(v, _layout.y_dv(d, v));
+					driving_cost[v] += cost_route;
+				}
+				else if (cost_route > 0)
+				{
+					// the costs of a route are divided over the zones it visits
+					std::vector<size_t> zones_route;
+					for (size_t i = 0; i < nb_zones; ++i)
+					{
+						for (size_t k = 0; k < nb_segments; ++k)
+						{
+							if (_fao_best_solution_cplex[_layout.w_dvik(d, v, i, k)] > 1e-6)
+							{
+								zones_route.push_back(i);
+								break;
+							}
+						}
+					}
+					for (size_t i : zones_route)
+						driving_cost[i] += cost_route / zones_route.size();
+				}
+			}
+
+			if (neighborhood != FAO_VEHICLES)
+			{
+				for (size_t i = 0; i < nb_zones; ++i)
+					add_binary(neighborhood == FAO_DAYS ? d : i, _layout.ksi_di(d, i));
+			}
+		}
+
+		// Scale every criterion to [0,1] and add them
+		std::vector<double> scores(nb_elements, 0.0);
+		for (auto criterion : { &fractionality, &difference, &reduced_cost, &driving_cost })
+		{
+			const double max_value = *std::max_element(criterion->begin(), criterion->end());
+			if (max_value <= 0)
+				continue;
+			for (size_t e = 0; e < nb_elements; ++e)
+				scores[e] += (*criterion)[e] / max_value;
+		}
+		return scores;
+	}
 
-		// Choose a neighborhood, fix all variables to current solution except those in the neighborhood and reoptimize until time out
+	void IP_model_integrated::fao_set_parameters()
+	{
 		// Set allowed computation time
-		int status = CPXsetdblparam(env, CPXPARAM_TimeLimit, _fao_max_comptime_subproblem);
+		fao_set_time_limit(_fao_max_comptime_subproblem);
+
+		// Set tolerance gap
+		int status = CPXsetdblparam(env, CPXPARAM_MIP_Tolerances_MIPGap, _optimality_tolerance);
 		if (status != 0)
 		{
 			char error_text[CPXMESSAGEBUFSIZE];
 			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_integrated::fix_and_optimize(). \nCouldn't set time limit. \nReason: " + std::string(error_text));
+			throw std::runtime_error("Error in function IP_model_integrated::fao_set_parameters(). \nCouldn't set optimality tolerance. \nReason: " + std::string(error_text));
 		}
-		// Set tolerance gap
-		status = CPXsetdblparam(env, CPXPARAM_MIP_Tolerances_MIPGap, _optimality_tolerance);
+
+		// Emphasis feasibility for the subproblems (also set by fao_initial_solution_cplex(), here for the environments of the workers)
+		status = CPXsetintparam(env, CPXPARAM_Emphasis_MIP, CPX_MIPEMPHASIS_FEASIBILITY);
 		if (status != 0)
 		{
 			char error_text[CPXMESSAGEBUFSIZE];
 			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_allocation::solve_problem(). \nCouldn't set optimality tolerance. \nReason: " + std::string(error_text));
+			throw std::runtime_error("Error in function IP_model_integrated::fao_set_parameters(). \nCouldn't set search strategy. \nReason: " + std::string(error_text));
+		}
+	}
+
+	void IP_model_integrated::fao_set_time_limit(double time_limit)
+	{
+		int status = CPXsetdblparam(env, CPXPARAM_TimeLimit, time_limit);
+		if (status != 0)
+		{
+			char error_text[CPXMESSAGEBUFSIZE];
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_set_time_limit(). \nCouldn't set time limit. \nReason: " + std::string(error_text));
+		}
+	}
+
+	void IP_model_integrated::fao_worker(const Instance& data, Fao_Search_State& state, std::chrono::system_clock::time_point start_time, uint64_t seed)
+	{
+		// Data
+		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
+		const size_t nb_trucks = _max_nb_trucks;
+		const size_t nb_zones = data.nb_zones();
+
+		std::mt19937_64 engine(seed);
+		std::chrono::duration<double, std::ratio<1, 1>> elapsed_time;
+
+		// Best solution known by this worker (one consistent copy, another worker may already be publishing a solution)
+		unsigned version;
+		double best_objval;
+		{
+			std::lock_guard<std::mutex> lock(state.mutex);
+			version = state.version;
+			best_objval = state.objective_value;
+			_fao_best_solution_cplex = state.solution;
 		}
 
+		// Get the best solution of the other workers (only copied if it has changed)
+		auto fetch_best_solution = [&]()
+		{
+			if (state.version != version)
+			{
+				std::lock_guard<std::mutex> lock(state.mutex);
+				version = state.version;
+				best_objval = state.objective_value;
+				_fao_best_solution_cplex = state.solution;
+			}
+		};
+
+		// Share an improved solution with the other workers (copy-on-improve)
+		auto publish_solution = [&](double current_objval)
+		{
+			if (current_objval >= state.objective_value) // no lock needed if no improvement
+				return false;
+
+			std::lock_guard<std::mutex> lock(state.mutex);
+			if (current_objval >= state.objective_value) // another worker was faster
+				return false;
+
+			state.solution = _fao_current_solution_cplex;
+			state.objective_value = current_objval;
+			version = ++state.version;
+			best_objval = current_objval;
+			_fao_best_solution_cplex = _fao_current_solution_cplex;
+			return true;
+		};
+
 
 
 		// Parameters fix-and-optimize
-		std::uniform_int_distribution<> dist_neighborhood(0, 2); // days / zones / vehicles
-		std::uniform_int_distribution<> neighborhood_days(0, nb_days_total - 1);
-		std::uniform_int_distribution<> neighborhood_zones(0, nb_zones - 1);
-		std::uniform_int_distribution<> neighborhood_vehicles(0, nb_trucks - 1);
-		size_t size_neighborhood_days = 2;
-		size_t size_neighborhood_zones = 3;
-		size_t size_neighborhood_vehicles = 1;
-		int iterations_without_improvement_days = 0;
-		int iterations_without_improvement_zones = 0;
-		int iterations_without_improvement_vehicles = 0;
-		int max_iterations_without_improvement = 1;
+		// Adaptive neighborhood selection (as in ALNS):
+		//  - the probability to choose a type of neighborhood depends on the improvement per second it recently achieved
+		//  - a neighborhood that is solved to optimality without improvement grows, a neighborhood that hits the time limit shrinks
+		//  - the time limit of a subproblem never exceeds the remaining computation time
+		// (the size of the local branching neighborhood is the number of ksi_di and y_dv that can change)
+		const char* name_neighborhood[FAO_NB_NEIGHBORHOODS] = { "days", "vehicles", "zones", "local branching" };
+		const size_t max_size_neighborhood[FAO_NB_NEIGHBORHOODS] = { nb_days_total, nb_trucks, nb_zones, nb_days_total * (nb_zones + nb_trucks) };
+		const size_t step_size_neighborhood[FAO_NB_NEIGHBORHOODS] = { 1, 1, 1, 5 };
+		size_t size_neighborhood[FAO_NB_NEIGHBORHOODS] = { 2, 1, 3, 10 };
+		double weight_neighborhood[FAO_NB_NEIGHBORHOODS] = { 0, 0, 0, 0 };	// smoothed improvement per second
+		const double reaction_factor = 0.3;		// weight of the last result in the smoothed improvement per second
+		const double min_probability = 0.1;		// every type of neighborhood keeps being chosen now and then
+
+		// Time limit subproblem (returns false if the total computation time is used up or another worker failed)
+		auto set_time_limit = [&]()
+		{
+			elapsed_time = std::chrono::system_clock::now() - start_time;
+			std::cout << "\n\nElapsed time (s): " << elapsed_time.count();
+			const double remaining_time = _max_computation_time - elapsed_time.count();
+			if (remaining_time <= 0 || state.stop)
+				return false;
+
+			fao_set_time_limit(std::min(_fao_max_comptime_subproblem, std::max(remaining_time, 1.0)));
+			return true;
+		};
 
 
 
 		// Start local search
-		// First iterate over zones
-		for (int i = 0; i < nb_zones; i += size_neighborhood_zones)
+		// First iterate over zones (the workers share the blocks of zones)
+		// If the neighborhoods are LP-guided, the most promising zones come first (same order for all workers: they start from the same solution)
+		std::vector<int> zone_order(nb_zones);
+		std::iota(zone_order.begin(), zone_order.end(), 0);
+		if (_fao_lp_guided)
+		{
+			const std::vector<double> scores = fao_guided_scores(data, FAO_ZONES);
+			std::stable_sort(zone_order.begin(), zone_order.end(), [&scores](int a, int b) { return scores[a] > scores[b]; });
+		}
+
+		for (size_t i = state.next_zone.fetch_add(size_neighborhood[FAO_ZONES]); i < nb_zones; i = state.next_zone.fetch_add(size_neighborhood[FAO_ZONES]))
 		{
 			// Time check
-			elapsed_time = std::chrono::system_clock::now() - start_time;
-			std::cout << "\n\nElapsed time (s): " << elapsed_time.count();
-			if (elapsed_time.count() > _max_computation_time)
+			if (!set_time_limit())
 				break;
 
 			// Select zones and solve
+			fetch_best_solution();
 			std::vector<int> zones_free;
-			for (int ii = i; ii < i + size_neighborhood_zones; ++ii)
-				zones_free.push_back(ii);
+			for (size_t ii = i; ii < std::min(i + size_neighborhood[FAO_ZONES], nb_zones); ++ii)
+				zones_free.push_back(zone_order[ii]);
 			double current_objval = fao_search_neighborhood_zones(data, zones_free);
+			++state.nb_neighborhoods;
 
-			if (current_objval < best_objval)
-			{
-				best_objval = current_objval;
-				for (int j = 0; j < CPXgetnumcols(env, problem); ++j)
-					_fao_best_solution_cplex[j] = _fao_current_solution_cplex[j];
-			}
+			publish_solution(current_objval);
 		}
 
 		// Then switch between neighborhoods
-		int neighborhood_previous = -1;
-		int neighborhood = 0;
 		while (true)
 		{
 			// Time check
-			elapsed_time = std::chrono::system_clock::now() - start_time;
-			std::cout << "\n\nElapsed time (s): " << elapsed_time.count();
-			if (elapsed_time.count() > _max_computation_time)
+			if (!set_time_limit())
 				break;
 
-			// Choose neighborhood
-			do
+			// Choose neighborhood (roulette wheel)
+			double probability[FAO_NB_NEIGHBORHOODS];
+			const double sum_weights = std::accumulate(std::begin(weight_neighborhood), std::end(weight_neighborhood), 0.0);
+			for (int n = 0; n < FAO_NB_NEIGHBORHOODS; ++n)
 			{
-				neighborhood = dist_neighborhood(engine);
-			} while (neighborhood == neighborhood_previous);
-			neighborhood_previous = neighborhood;
+				if (sum_weights > 0)
+					probability[n] = min_probability + (1.0 - FAO_NB_NEIGHBORHOODS * min_probability) * weight_neighborhood[n] / sum_weights;
+				else
+					probability[n] = 1.0 / FAO_NB_NEIGHBORHOODS;
+			}
+			std::discrete_distribution<> dist_neighborhood(std::begin(probability), std::end(probability));
+			const int neighborhood = dist_neighborhood(engine);
 
-			// Search neighborhood
-			if (neighborhood <= 0) // days
+			// Select days / vehicles / zones (around the best solution of all workers)
+			fetch_best_solution();
+			std::vector<int> elements_free;
+			if (neighborhood == FAO_LOCAL_BRANCHING)
 			{
-				// Select days
-				std::vector<int> days_free;
-				{
-					int added = 0;
-					while (added < size_neighborhood_days)
-					{
-						int dayfree = neighborhood_days(engine);
-						if (std::find(days_free.begin(), days_free.end(), dayfree) == days_free.end()) // not twice same day
-						{
-							days_free.push_back(dayfree);
-							++added;
-						}
-					}
-				}
-
-				double current_objval = fao_search_neighborhood_days(data, days_free);
-				++iterations_without_improvement_days;
-
-				if (current_objval < best_objval)
-				{
-					best_objval = current_objval;
-					for (int j = 0; j < CPXgetnumcols(env, problem); ++j)
-						_fao_best_solution_cplex[j] = _fao_current_solution_cplex[j];
-
-					iterations_without_improvement_days = 0;
-				}
-
-				if (iterations_without_improvement_days >= max_iterations_without_improvement)
-				{
-					if (size_neighborhood_days < nb_days_total)
-					{
-						++size_neighborhood_days;
-						std::cout << "\nIncrease size neighborhood days to " << size_neighborhood_days;
-						iterations_without_improvement_days = 0;
-					}
-				}
+				// no elements: the neighborhood is defined by its size k
 			}
-			else if(neighborhood <= 1) // vehicles
+			else if (_fao_lp_guided)
 			{
-				// Select vehicles
-				std::vector<int> vehicles_free;
-				{
-					int added = 0;
-					while (added < size_neighborhood_vehicles)
-					{
-						int vehiclefree = neighborhood_vehicles(engine);
-						if (std::find(vehicles_free.begin(), vehicles_free.end(), vehiclefree) == vehicles_free.end()) // not twice same vehicle
-						{
-							vehicles_free.push_back(vehiclefree);
-							++added;
-						}
-					}
-				}
-
-				double current_objval = fao_search_neighborhood_vehicles(data, vehicles_free);
-				++iterations_without_improvement_vehicles;
-
-				if (current_objval < best_objval)
-				{
-					best_objval = current_objval;
-					for (int j = 0; j < CPXgetnumcols(env, problem); ++j)
-						_fao_best_solution_cplex[j] = _fao_current_solution_cplex[j];
-
-					iterations_without_improvement_vehicles = 0;
-				}
-
-				if (iterations_without_improvement_vehicles >= max_iterations_without_improvement)
+				// the most promising elements have the highest probability to be chosen (every element keeps a small probability)
+				std::vector<double> scores = fao_guided_scores(data, neighborhood);
+				for (auto&& score : scores)
+					score += 0.1;
+				while (elements_free.size() < size_neighborhood[neighborhood])
 				{
-					if (size_neighborhood_vehicles < nb_trucks)
-					{
-						++size_neighborhood_vehicles;
-						std::cout << "\nIncrease size neighborhood vehicles to " << size_neighborhood_vehicles;
-						iterations_without_improvement_vehicles = 0;
-					}
+					std::discrete_distribution<> dist_element(scores.begin(), scores.end());
+					const int elementfree = dist_element(engine);
+					elements_free.push_back(elementfree);
+					scores[elementfree] = 0; // not twice the same
 				}
 			}
-			else if (neighborhood <= 2) // zones
+			else
 			{
-				// Select zones
-				std::vector<int> zones_free;
+				std::uniform_int_distribution<> dist_element(0, static_cast<int>(max_size_neighborhood[neighborhood]) - 1);
+				while (elements_free.size() < size_neighborhood[neighborhood])
 				{
-					int added = 0;
-					while (added < size_neighborhood_zones)
-					{
-						int zonefree = neighborhood_zones(engine);
-						if (std::find(zones_free.begin(), zones_free.end(), zonefree) == zones_free.end()) // not twice same zone
-						{
-							zones_free.push_back(zonefree);
-							++added;
-						}
-					}
+					int elementfree = dist_element(engine);
+					if (std::find(elements_free.begin(), elements_free.end(), elementfree) == elements_free.end()) // not twice the same
+						elements_free.push_back(elementfree);
 				}
+			}
 
-				double current_objval = fao_search_neighborhood_zones(data, zones_free);
-				++iterations_without_improvement_zones;
-
-				if (current_objval < best_objval)
+			// Search neighborhood
+			auto start_time_neighborhood = std::chrono::system_clock::now();
+
+			double current_objval = 1e20;
+			if (neighborhood == FAO_DAYS)
+				current_objval = fao_search_neighborhood_days(data, elements_free);
+			else if (neighborhood == FAO_VEHICLES)
+				current_objval = fao_search_neighborhood_vehicles(data, elements_free);
+			else if (neighborhood == FAO_ZONES)
+				current_objval = fao_search_neighborhood_zones(data, elements_free);
+			else
+				current_objval = fao_search_neighborhood_local_branching(data, size_neighborhood[neighborhood]);
+
+			std::chrono::duration<double, std::ratio<1, 1>> solve_time = std::chrono::system_clock::now() - start_time_neighborhood;
+			++state.nb_neighborhoods;
+
+			const double improvement = std::max(0.0, best_objval - current_objval);
+			publish_solution(current_objval);
+
+			// Update weight
+			weight_neighborhood[neighborhood] = (1.0 - reaction_factor) * weight_neighborhood[neighborhood]
+				+ reaction_factor * improvement / std::max(solve_time.count(), 1e-3);
+
+			// Update size
+			if (improvement <= 0)
+			{
+				const bool optimal = (_fao_solstat == CPXMIP_OPTIMAL || _fao_solstat == CPXMIP_OPTIMAL_TOL);
+				if (optimal && size_neighborhood[neighborhood] < max_size_neighborhood[neighborhood])
 				{
-					best_objval = current_objval;
-					for (int j = 0; j < CPXgetnumcols(env, problem); ++j)
-						_fao_best_solution_cplex[j] = _fao_current_solution_cplex[j];
-
-					iterations_without_improvement_zones = 0;
+					size_neighborhood[neighborhood] = std::min(size_neighborhood[neighborhood] + step_size_neighborhood[neighborhood], max_size_neighborhood[neighborhood]);
+					std::cout << "\nIncrease size neighborhood " << name_neighborhood[neighborhood] << " to " << size_neighborhood[neighborhood];
 				}
-
-				if (iterations_without_improvement_zones >= max_iterations_without_improvement)
+				else if (!optimal && size_neighborhood[neighborhood] > 1)
 				{
-					if (size_neighborhood_zones < nb_zones)
-					{
-						++size_neighborhood_zones;
-						std::cout << "\nIncrease size neighborhood zones to " << size_neighborhood_zones;
-						iterations_without_improvement_zones = 0;
-					}
+					size_neighborhood[neighborhood] -= std::min(step_size_neighborhood[neighborhood], size_neighborhood[neighborhood] - 1);
+					std::cout << "\nDecrease size neighborhood " << name_neighborhood[neighborhood] << " to " << size_neighborhood[neighborhood];
 				}
 			}
 		}
 
-		std::cout << "\n\nFixe-and-optimize: time limit reached ... ";
-		std::cout << "\nBest objective value: " << best_objval;
-		_objective_value = best_objval;
+		for (int n = 0; n < FAO_NB_NEIGHBORHOODS; ++n)
+			std::cout << "\nNeighborhood " << name_neighborhood[n] << ": size " << size_neighborhood[n] << ", improvement per second " << weight_neighborhood[n];
 
-		// store solution
-		fao_write_solution_file(data);
+		// Time spent on fixing by this worker
+		std::lock_guard<std::mutex> lock(state.mutex);
+		state.fixing_time += _fao_fixing_time;
+		_fao_fixing_time = 0;
 	}
 
 	double IP_model_integrated::fao_initial_solution_cplex()
@@ -1833,8 +1725,8 @@ namespace IVM
 		// Obtain solution 
 		// Assign memory for solution
 		const int numvar = CPXgetnumcols(env, problem);
-		_fao_current_solution_cplex = std::make_unique<double[]>(numvar);
-		_fao_best_solution_cplex = std::make_unique<double[]>(numvar);
+		_fao_current_solution_cplex.assign(numvar, 0.0);
+		_fao_best_solution_cplex.assign(numvar, 0.0);
 
 		// Optimize the problem
 		std::cout << "\n\nFix-and-optimize: finding initial solution using CPLEX ...";
@@ -1851,7 +1743,7 @@ namespace IVM
 
 
 		// Get the solution
-		status = CPXsolution(env, problem, &solstat, &objval, _fao_current_solution_cplex.get(), NULL, NULL, NULL);
+		status = CPXsolution(env, problem, &solstat, &objval, _fao_current_solution_cplex.data(), NULL, NULL, NULL);
 		if (status != 0)
 		{
 			CPXgeterrorstring(env, status, error_text);
@@ -1870,67 +1762,73 @@ namespace IVM
 			throw std::runtime_error("Fix-and-optimize: Did not find a feasible start solution.");
 
 		// save best solution
-		for (int i = 0; i < CPXgetnumcols(env, problem); ++i)
-			_fao_best_solution_cplex[i] = _fao_current_solution_cplex[i];
+		_fao_best_solution_cplex = _fao_current_solution_cplex;
 
 		return objval;
 	}
 
-	double IP_model_integrated::fao_search_neighborhood_days(const Instance& data, const std::vector<int>& days_free)
+	double IP_model_integrated::fao_solve_subproblem(const char* name)
 	{
-		// Number of constraints before fixing variables
-		const int nb_rows_default = CPXgetnumrows(env, problem);
+		int status = CPXmipopt(env, problem);
+		if (status != 0)
+		{
+			char error_text[CPXMESSAGEBUFSIZE];
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_solve_subproblem(). \nCPXmipopt failed for neighborhood " + std::string(name) + ". \nReason: " + std::string(error_text));
+		}
 
+		int solstat;
+		double objval;
+		status = CPXsolution(env, problem, &solstat, &objval, _fao_current_solution_cplex.data(), NULL, NULL, NULL);
+		_fao_solstat = (status == 0) ? solstat : 0;
+		if (status != 0)
+		{
+			std::cout << "\nNo solution exists ... ";
+			return 1e20;
+		}
+
+		char solstat_text[CPXMESSAGEBUFSIZE];
+		if (CPXgetstatstring(env, solstat, solstat_text) == nullptr)
+			std::strcpy(solstat_text, "unknown");
+		std::cout << "\nSolstat: " << solstat_text;
+		std::cout << "\nObjective value: " << objval;
+
+		if (solstat != CPXMIP_OPTIMAL && solstat != CPXMIP_OPTIMAL_TOL && solstat != CPXMIP_TIME_LIM_FEAS)
+			return 1e20;
+		return objval;
+	}
+
+	double IP_model_integrated::fao_search_neighborhood_days(const Instance& data, const std::vector<int>& days_free)
+	{
 		// Data
 		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
-		const size_t nb_trucks = _max_nb_trucks;
-		const size_t nb_segments = _max_nb_segments;
-		const size_t nb_zones = data.nb_zones();
-		const size_t nb_collection_points = data.nb_collection_points();
-		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
 
-		const int startindex_x_dvijk = 0;
-		const int startindex_w_dvik = startindex_x_dvijk + nb_days_total * nb_trucks * nb_locations * nb_locations * nb_segments;
-		const int startindex_y_dv = startindex_w_dvik + nb_days_total * nb_trucks * nb_zones * nb_segments;
-		const int startindex_beta_dv = startindex_y_dv + nb_days_total * nb_trucks;
-		const int startindex_z = startindex_beta_dv + nb_days_total * nb_trucks;
-		const int startindex_ksi_di = startindex_z + 1;
-
-		// Lambdas to get variable indices
-		auto index_y_dv = [startindex_y_dv, nb_trucks](int d, int v) -> int {
-			return startindex_y_dv + d * nb_trucks + v;
-			};
-		auto index_ksi_di = [startindex_ksi_di, nb_zones](int d, int m) -> int {
-			return startindex_ksi_di + d * nb_zones + m;
-			};
 
 		// Fix current solution (except neighborhood)
 		for (int d = 0; d < nb_days_total; ++d)
 		{
 			if (std::find(days_free.begin(), days_free.end(), d) == days_free.end()) // not days in neighborhood
 			{
-				for (int v = 0; v < nb_trucks; ++v)
+				// y_dv and ksi_di of this day (contiguous columns)
+				for (auto&& columns : { _layout.y_dv.slice(d), _layout.ksi_di.slice(d) })
 				{
-					// y_dv
+					for (size_t index : columns)
 					{
-						const int index = index_y_dv(d, v);
 						const double value = _fao_best_solution_cplex[index];
 						fao_fix_variable(index, value);
 					}
 				}
-
-				// ksi_di
-				for (int i = 0; i < nb_zones; ++i) // enkel zones
-				{
-					const int index = index_ksi_di(d, i);
-					const double value = _fao_best_solution_cplex[index];
-					fao_fix_variable(index, value);
-				}
 			}
 		}
 		
+		fao_apply_fixings();
+
+		// Start from the best solution (satisfies the fixings, so the neighborhood can only improve it)
+		fao_add_mip_start();
+
 #if _DEBUG
-		// Write to file
+		// Write to file (not with several workers, they would all write the same file)
+		if (_fao_nb_workers <= 1)
 		{
 			int status = CPXwriteprob(env, problem, "IP_model_integrated.lp", NULL);
 			if (status != 0)
@@ -1945,72 +1843,20 @@ namespace IVM
 		// Solve the problem and get the solution
 		std::cout << "\nSolving neighborhood days ...";
 
-		int status = CPXmipopt(env, problem);
-		if (status != 0)
-		{
-			char error_text[CPXMESSAGEBUFSIZE];
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_days(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
-		}
-
-		int solstat;
-		double objval;
-		status = CPXsolution(env, problem, &solstat, &objval, _fao_current_solution_cplex.get(), NULL, NULL, NULL);
-		if (status != 0)
-		{
-			std::cout << "\nNo solution exists ... ";
-			objval = 1e20;
-		}
-		else
-		{
-			char solstat_text[CPXMESSAGEBUFSIZE];
-			auto p = CPXgetstatstring(env, solstat, solstat_text);
-			std::cout << "\nSolstat: " << solstat_text;
-			std::cout << "\nObjective value: " << objval;
-
-			if (solstat != CPXMIP_OPTIMAL && solstat != CPXMIP_OPTIMAL_TOL && solstat != CPXMIP_TIME_LIM_FEAS)
-				objval = 1e20;
-		}
+		const double objval = fao_solve_subproblem("days");
 
-		// Delete added constraints
-		if (CPXgetnumrows(env, problem) > nb_rows_default) // enkel indien constraints toegevoegd (als neighborhood heel probleem is, wordt er niets toegevoegd)
-		{
-			status = CPXdelrows(env, problem, nb_rows_default, CPXgetnumrows(env, problem) - 1);
-			if (status != 0)
-			{
-				char error_text[CPXMESSAGEBUFSIZE];
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_days(). \nCoudln't delete added constraints fixed variables. \nReason: " + std::string(error_text));
-			}
-		}
+		// Release fixed variables
+		fao_release_fixings();
 
 		return objval;
 	}
 
 	double IP_model_integrated::fao_search_neighborhood_zones(const Instance& data, const std::vector<int>& zones_free)
 	{
-		// Number of constraints before fixing variables
-		const int nb_rows_default = CPXgetnumrows(env, problem);
-
 		// Data
 		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
-		const size_t nb_trucks = _max_nb_trucks;
-		const size_t nb_segments = _max_nb_segments;
 		const size_t nb_zones = data.nb_zones();
-		const size_t nb_collection_points = data.nb_collection_points();
-		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
-
-		const int startindex_x_dvijk = 0;
-		const int startindex_w_dvik = startindex_x_dvijk + nb_days_total * nb_trucks * nb_locations * nb_locations * nb_segments;
-		const int startindex_y_dv = startindex_w_dvik + nb_days_total * nb_trucks * nb_zones * nb_segments;
-		const int startindex_beta_dv = startindex_y_dv + nb_days_total * nb_trucks;
-		const int startindex_z = startindex_beta_dv + nb_days_total * nb_trucks;
-		const int startindex_ksi_di = startindex_z + 1;
 
-		// Lambdas to get variable indices
-		auto index_ksi_di = [startindex_ksi_di, nb_zones](int d, int m) -> int {
-			return startindex_ksi_di + d * nb_zones + m;
-			};
 
 		// Fix current solution (except neighborhood)
 		for (int d = 0; d < nb_days_total; ++d)
@@ -2020,15 +1866,21 @@ namespace IVM
 			{
 				if (std::find(zones_free.begin(), zones_free.end(), i) == zones_free.end()) // not zones in neighborhood
 				{
-					const int index = index_ksi_di(d, i);
+					const size_t index = _layout.ksi_di(d, i);
 					const double value = _fao_best_solution_cplex[index];
 					fao_fix_variable(index, value);
 				}
 			}
 		}
 
+		fao_apply_fixings();
+
+		// Start from the best solution (satisfies the fixings, so the neighborhood can only improve it)
+		fao_add_mip_start();
+
 #if _DEBUG
-		// Write to file
+		// Write to file (not with several workers, they would all write the same file)
+		if (_fao_nb_workers <= 1)
 		{
 			int status = CPXwriteprob(env, problem, "IP_model_integrated.lp", NULL);
 			if (status != 0)
@@ -2043,72 +1895,20 @@ namespace IVM
 		// Solve the problem and get the solution
 		std::cout << "\nSolving neighborhood zones ...";
 
-		int status = CPXmipopt(env, problem);
-		if (status != 0)
-		{
-			char error_text[CPXMESSAGEBUFSIZE];
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_zones(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
-		}
-
-		int solstat;
-		double objval;
-		status = CPXsolution(env, problem, &solstat, &objval, _fao_current_solution_cplex.get(), NULL, NULL, NULL);
-		if (status != 0)
-		{
-			std::cout << "\nNo solution exists ... ";
-			objval = 1e20;
-		}
-		else
-		{
-			char solstat_text[CPXMESSAGEBUFSIZE];
-			auto p = CPXgetstatstring(env, solstat, solstat_text);
-			std::cout << "\nSolstat: " << solstat_text;
-			std::cout << "\nObjective value: " << objval;
-
-			if (solstat != CPXMIP_OPTIMAL && solstat != CPXMIP_OPTIMAL_TOL && solstat != CPXMIP_TIME_LIM_FEAS)
-				objval = 1e20;
-		}
+		const double objval = fao_solve_subproblem("zones");
 
-		// Delete added constraints
-		if (CPXgetnumrows(env, problem) > nb_rows_default) // enkel indien constraints toegevoegd (als neighborhood heel probleem is, wordt er niets toegevoegd)
-		{
-			status = CPXdelrows(env, problem, nb_rows_default, CPXgetnumrows(env, problem) - 1);
-			if (status != 0)
-			{
-				char error_text[CPXMESSAGEBUFSIZE];
-				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_zones(). \nCoudln't delete added constraints fixed variables. \nReason: " + std::string(error_text));
-			}
-		}
+		// Release fixed variables
+		fao_release_fixings();
 
 		return objval;
 	}
 
 	double IP_model_integrated::fao_search_neighborhood_vehicles(const Instance& data, const std::vector<int>& vehicles_free)
 	{
-		// Number of constraints before fixing variables
-		const int nb_rows_default = CPXgetnumrows(env, problem);
-
 		// Data
 		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
 		const size_t nb_trucks = _max_nb_trucks;
-		const size_t nb_segments = _max_nb_segments;
-		const size_t nb_zones = data.nb_zones();
-		const size_t nb_collection_points = data.nb_collection_points();
-		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
-
-		const int startindex_x_dvijk = 0;
-		const int startindex_w_dvik = startindex_x_dvijk + nb_days_total * nb_trucks * nb_locations * nb_locations * nb_segments;
-		const int startindex_y_dv = startindex_w_dvik + nb_days_total * nb_trucks * nb_zones * nb_segments;
-		const int startindex_beta_dv = startindex_y_dv + nb_days_total * nb_trucks;
-		const int startindex_z = startindex_beta_dv + nb_days_total * nb_trucks;
-		const int startindex_ksi_di = startindex_z + 1;
 
-		// Lambdas to get variable indices
-		auto index_y_dv = [startindex_y_dv, nb_trucks](int d, int v) -> int {
-			return startindex_y_dv + d * nb_trucks + v;
-			};
 
 		// Fix current solution (except neighborhood)
 		for (int d = 0; d < nb_days_total; ++d)
@@ -2117,15 +1917,21 @@ namespace IVM
 			{
 				if (std::find(vehicles_free.begin(), vehicles_free.end(), v) == vehicles_free.end()) // not vehicles in neighborhood
 				{
-					const int index = index_y_dv(d, v);
+					const size_t index = _layout.y_dv(d, v);
 					const double value = _fao_best_solution_cplex[index];
 					fao_fix_variable(index, value);
 				}
 			}
 		}
 
+		fao_apply_fixings();
+
+		// Start from the best solution (satisfies the fixings, so the neighborhood can only improve it)
+		fao_add_mip_start();
+
 #if _DEBUG
-		// Write to file
+		// Write to file (not with several workers, they would all write the same file)
+		if (_fao_nb_workers <= 1)
 		{
 			int status = CPXwriteprob(env, problem, "IP_model_integrated.lp", NULL);
 			if (status != 0)
@@ -2140,84 +1946,183 @@ namespace IVM
 		// Solve the problem and get the solution
 		std::cout << "\nSolving neighborhood vehicles ...";
 
-		int status = CPXmipopt(env, problem);
-		if (status != 0)
+		const double objval = fao_solve_subproblem("vehicles");
+
+		// Release fixed variables
+		fao_release_fixings();
+
+		return objval;
+	}
+
+	double IP_model_integrated::fao_search_neighborhood_local_branching(const Instance& data, size_t k)
+	{
+		// Data
+		const size_t nb_days_total = data.nb_days() * data.nb_weeks();
+
+
+		// Local branching constraint around the best solution (soft fixing instead of fixing variables):
+		// sum(j: best_j == 0) x_j + sum(j: best_j == 1) (1 - x_j) <= k   over all ksi_di and y_dv
+		std::vector<int> matind;
+		std::vector<double> matval;
+		double rhs = static_cast<double>(k);
+		for (int d = 0; d < nb_days_total; ++d)
 		{
-			char error_text[CPXMESSAGEBUFSIZE];
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_vehicles(). \nCPXmipopt failed. \nReason: " + std::string(error_text));
+			for (auto&& columns : { _layout.y_dv.slice(d), _layout.ksi_di.slice(d) })
+			{
+				for (size_t index : columns)
+				{
+					matind.push_back(static_cast<int>(index));
+					if (_fao_best_solution_cplex[index] > 0.5)
+					{
+						matval.push_back(-1);
+						rhs -= 1;
+					}
+					else
+						matval.push_back(1);
+				}
+			}
 		}
 
-		int solstat;
-		double objval;
-		status = CPXsolution(env, problem, &solstat, &objval, _fao_current_solution_cplex.get(), NULL, NULL, NULL);
+		const int nb_rows_default = CPXgetnumrows(env, problem);
+		const char sense = 'L';
+		const int matbeg = 0;
+		int status = CPXaddrows(env, problem, 0, 1, static_cast<int>(matind.size()), &rhs, &sense, &matbeg, matind.data(), matval.data(), NULL, NULL);
 		if (status != 0)
 		{
-			std::cout << "\nNo solution exists ... ";
-			objval = 1e20;
+			char error_text[CPXMESSAGEBUFSIZE];
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_local_branching(). \nCouldn't add local branching constraint. \nReason: " + std::string(error_text));
 		}
-		else
-		{
-			char solstat_text[CPXMESSAGEBUFSIZE];
-			auto p = CPXgetstatstring(env, solstat, solstat_text);
-			std::cout << "\nSolstat: " << solstat_text;
-			std::cout << "\nObjective value: " << objval;
 
-			if (solstat != CPXMIP_OPTIMAL && solstat != CPXMIP_OPTIMAL_TOL && solstat != CPXMIP_TIME_LIM_FEAS)
-				objval = 1e20;
-		}
+		// Start from the best solution (satisfies the constraint, so the neighborhood can only improve it)
+		fao_add_mip_start();
 
-		// Delete added constraints
-		if (CPXgetnumrows(env, problem) > nb_rows_default) // enkel indien constraints toegevoegd (als neighborhood heel probleem is, wordt er niets toegevoegd)
+#if _DEBUG
+		// Write to file (not with several workers, they would all write the same file)
+		if (_fao_nb_workers <= 1)
 		{
-			status = CPXdelrows(env, problem, nb_rows_default, CPXgetnumrows(env, problem) - 1);
+			int status = CPXwriteprob(env, problem, "IP_model_integrated.lp", NULL);
 			if (status != 0)
 			{
 				char error_text[CPXMESSAGEBUFSIZE];
 				CPXgeterrorstring(env, status, error_text);
-				throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_vehicles(). \nCoudln't delete added constraints fixed variables. \nReason: " + std::string(error_text));
+				throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_local_branching(). \nCouldn't write problem to lp-file. \nReason: " + std::string(error_text));
 			}
 		}
+#endif
+
+		// Solve the problem and get the solution
+		std::cout << "\nSolving neighborhood local branching (k = " << k << ") ...";
+
+		const double objval = fao_solve_subproblem("local branching");
+
+		// Delete local branching constraint
+		status = CPXdelrows(env, problem, nb_rows_default, nb_rows_default);
+		if (status != 0)
+		{
+			char error_text[CPXMESSAGEBUFSIZE];
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_search_neighborhood_local_branching(). \nCouldn't delete local branching constraint. \nReason: " + std::string(error_text));
+		}
 
 		return objval;
 	}
 
-	void IP_model_integrated::fao_fix_variable(size_t index_variable, int value)
+	void IP_model_integrated::fao_fix_variable(size_t index_variable, double value)
 	{
-		char error_text[CPXMESSAGEBUFSIZE];
-		int status = 0;
-		double rhs[1];			// Right-hand side constraints
-		char sense[1];			// Sign of constraint
-		int nonzeroes = 0;		// To calculate number of nonzero coefficients in each constraint
-		int matbeg[1];			// Begin position of the constraint
-		int matind[1];			// Position of each element in constraint matrix
-		double matval[1];		// Value of each element in constraint matrix
+		// only binary variables are fixed: round away the tolerances of CPLEX
+		_fao_fixed_indices.push_back(static_cast<int>(index_variable));
+		_fao_fixed_values.push_back(std::round(value));
+	}
+
+	void IP_model_integrated::fao_apply_fixings()
+	{
+		if (_fao_fixed_indices.empty()) // neighborhood is the whole problem
+			return;
 
-		matbeg[0] = 0;
+		auto start_time = std::chrono::system_clock::now();
+		const std::vector<char> lu(_fao_fixed_indices.size(), 'B');
+		int status = CPXchgbds(env, problem, static_cast<int>(_fao_fixed_indices.size()), _fao_fixed_indices.data(), lu.data(), _fao_fixed_values.data());
+		if (status != 0)
+		{
+			char error_text[CPXMESSAGEBUFSIZE];
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_integrated::fao_apply_fixings(). \nCouldn't fix variables. \nReason: " + std::string(error_text));
+		}
+
+		std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+		_fao_fixing_time += elapsed_time.count();
+	}
 
-		rhs[0] = value;
-		sense[0] = 'E';
+	void IP_model_integrated::fao_release_fixings()
+	{
+		if (_fao_fixed_indices.empty())
+			return;
+
+		auto start_time = std::chrono::system_clock::now();
+
+		// lower and upper bound of every fixed variable
+		std::vector<int> indices;
+		std::vector<char> lu;
+		std::vector<double> bd;
+		indices.reserve(2 * _fao_fixed_indices.size());
+		lu.reserve(2 * _fao_fixed_indices.size());
+		bd.reserve(2 * _fao_fixed_indices.size());
+		for (int index : _fao_fixed_indices)
+		{
+			indices.push_back(index);
+			lu.push_back('L');
+			bd.push_back(_fao_lb[index]);
 
-		nonzeroes = 0;
-		matind[nonzeroes] = index_variable;
-		matval[nonzeroes] = 1;
-		++nonzeroes;
+			indices.push_back(index);
+			lu.push_back('U');
+			bd.push_back(_fao_ub[index]);
+		}
 
-		status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind, matval, NULL, NULL);
+		int status = CPXchgbds(env, problem, static_cast<int>(indices.size()), indices.data(), lu.data(), bd.data());
 		if (status != 0)
 		{
+			char error_text[CPXMESSAGEBUFSIZE];
 			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_routing::fao_fix_variable(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
+			throw std::runtime_error("Error in function IP_model_integrated::fao_release_fixings(). \nCouldn't restore bounds fixed variables. \nReason: " + std::string(error_text));
+		}
+
+		_fao_fixed_indices.clear();
+		_fao_fixed_values.clear();
+
+		std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+		_fao_fixing_time += elapsed_time.count();
+	}
+
+	void IP_model_integrated::fao_add_mip_start()
+	{
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = 0;
+
+		// Remove the MIP starts of earlier neighborhoods
+		const int nb_mipstarts = CPXgetnummipstarts(env, problem);
+		if (nb_mipstarts > 0)
+		{
+			status = CPXdelmipstarts(env, problem, 0, nb_mipstarts - 1);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_integrated::fao_add_mip_start(). \nCouldn't delete MIP starts. \nReason: " + std::string(error_text));
+			}
 		}
 
-		// change name of constraint
-		int numrows = CPXgetnumrows(env, problem);
-		std::string conname = "fix_variable_c" + std::to_string(numrows + 1);
-		status = CPXchgname(env, problem, 'r', numrows - 1, conname.c_str());
+		// All variables of the best solution
+		const int numvar = CPXgetnumcols(env, problem);
+		std::vector<int> indices(numvar);
+		std::iota(indices.begin(), indices.end(), 0);
+
+		const int beg = 0;
+		const int effortlevel = CPX_MIPSTART_REPAIR;
+		status = CPXaddmipstarts(env, problem, 1, numvar, &beg, indices.data(), _fao_best_solution_cplex.data(), &effortlevel, NULL);
 		if (status != 0)
 		{
 			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_routing::fao_fix_variable(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
+			throw std::runtime_error("Error in function IP_model_integrated::fao_add_mip_start(). \nCouldn't add MIP start. \nReason: " + std::string(error_text));
 		}
 	}
 
@@ -2231,32 +2136,6 @@ namespace IVM
 		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
 		const size_t max_visits = _max_visits;
 
-		const int startindex_x_dvijk = 0;
-		const int startindex_w_dvik = startindex_x_dvijk + nb_days_total * nb_trucks * nb_locations * nb_locations * nb_segments;
-		const int startindex_y_dv = startindex_w_dvik + nb_days_total * nb_trucks * nb_zones * nb_segments;
-		const int startindex_beta_dv = startindex_y_dv + nb_days_total * nb_trucks;
-		const int startindex_z = startindex_beta_dv + nb_days_total * nb_trucks;
-		const int startindex_ksi_di = startindex_z + 1;
-
-
-		// lambdas to get variable indices
-		auto index_x_dvijk = [startindex_x_dvijk, nb_trucks, nb_locations, nb_segments](int d, int v, int i, int j, int k) -> int {
-			return startindex_x_dvijk + d * nb_trucks * nb_locations * nb_locations * nb_segments + v * nb_locations * nb_locations * nb_segments
-				+ i * nb_locations * nb_segments + j * nb_segments + k;
-			};
-		auto index_w_dvik = [startindex_w_dvik, nb_trucks, nb_zones, nb_segments](int d, int v, int i_zone, int k) -> int {
-			return startindex_w_dvik + d * nb_trucks * nb_zones * nb_segments + v * nb_zones * nb_segments + i_zone * nb_segments + k;
-			};
-		auto index_y_dv = [startindex_y_dv, nb_trucks](int d, int v) -> int {
-			return startindex_y_dv + d * nb_trucks + v;
-			};
-		auto index_beta_dv = [startindex_beta_dv, nb_trucks](int d, int v) -> int {
-			return startindex_beta_dv + d * nb_trucks + v;
-			};
-		auto index_ksi_di = [startindex_ksi_di, nb_zones](int d, int m) -> int {
-			return startindex_ksi_di + d * nb_zones + m;
-			};
-
 
 
 		// Solution to file
@@ -2290,15 +2169,15 @@ namespace IVM
 				// calculate routes
 				for (int d = 0; d < nb_days_total; ++d) {
 					for (int v = 0; v < nb_trucks; ++v) {
-						if (_fao_best_solution_cplex[index_y_dv(d, v)] > 0) {
+						if (_fao_best_solution_cplex[_layout.y_dv(d, v)] > 0) {
 							// route
 							Route newroute;
 							newroute.day = d;
-							newroute.hours = _fao_best_solution_cplex[index_beta_dv(d, v)];
+							newroute.hours = _fao_best_solution_cplex[_layout.beta_dv(d, v)];
 
 							for (int m = 0; m < nb_zones; ++m) {
 								for (int k = 0; k < nb_segments; ++k) {
-									double wval = _fao_best_solution_cplex[index_w_dvik(d, v, m, k)];
+									double wval = _fao_best_solution_cplex[_layout.w_dvik(d, v, m, k)];
 									if (wval > 0.001) {
 										int wvalkg = static_cast<int>(wval * 1000 + 0.001);
 										newroute.amounts.push_back(wvalkg);
@@ -2309,7 +2188,9 @@ namespace IVM
 							for (int k = 0; k < nb_segments; ++k) {
 								for (int i = 0; i < nb_locations; ++i) {
 									for (int j = 0; j < nb_locations; ++j) {
-										int xval = static_cast<int>(_fao_best_solution_cplex[index_x_dvijk(d, v, i, j, k)] + 0.001);
+										if (!_layout.x_dvijk.contains(d, i, j, k))
+											continue;
+										int xval = static_cast<int>(_fao_best_solution_cplex[_layout.x_dvijk(d, v, i, j, k)] + 0.001);
 										if (xval > 0) {
 											std::string destination;
 											if (j < nb_zones)
@@ -2345,7 +2226,7 @@ namespace IVM
 
 				// costs and trucks per day
 				solfile << "\n\n\nKosten: " << _objective_value;
-				solfile << "\nz = " << _fao_best_solution_cplex[startindex_z];
+				solfile << "\nz = " << _fao_best_solution_cplex[_layout.z()];
 				solfile << "\n\nDag\tTrucks";
 				for (int d = 0; d < nb_days_total; ++d) {
 					int trucksday = 0;
@@ -2382,7 +2263,7 @@ namespace IVM
 				for (int m = 0; m < nb_zones; ++m) {
 					solfile << "\n" << data.zone_name(m) << "\t";
 					for (int d = 0; d < nb_days_total; ++d) {
-						int ksi_di = static_cast<int>(_fao_best_solution_cplex[index_ksi_di(d, m)] + 0.001);
+						int ksi_di = static_cast<int>(_fao_best_solution_cplex[_layout.ksi_di(d, m)] + 0.001);
 						if (ksi_di > 0)
 							solfile << "gft";
 						solfile << "\t";
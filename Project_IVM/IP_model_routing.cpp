@@ -7,12 +7,22 @@
 
 #include "models.h"
 #include "data.h"
+#include "model_builder.h"
+#include "solution_view.h"
 #include <stdexcept>
 #include <memory>
 #include <iostream>
 #include <chrono>
 #include <fstream>
 #include <cassert>
+#include <algorithm>
+#include <tuple>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <exception>
 
 
 
@@ -45,30 +55,43 @@ namespace IVM
 			CPXgeterrorstring(env, status, error_text);
 			throw std::runtime_error("Error in function IP_model_routing::initialize_cplex(). \nCouldn't change param SCRIND. \nReason: " + std::string(error_text));
 		}
+
+		// limit the number of threads (if several days are solved in parallel)
+		if (_nb_threads > 0)
+		{
+			status = CPXsetintparam(env, CPXPARAM_Threads, _nb_threads);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_routing::initialize_cplex(). \nCouldn't change param Threads. \nReason: " + std::string(error_text));
+			}
+		}
 	}
 
-	void IP_model_routing::build_problem(const Instance& data, size_t day)
+	double IP_model_routing::arc_time(const Instance& data, int q, int i, int j) const
 	{
-		char error_text[CPXMESSAGEBUFSIZE];
-		int status = 0;
-		double obj[1];			// Objective function
-		double lb[1];			// Lower bound variables
-		double ub[1];			// Upper bound variables
-		double rhs[1];			// Right-hand side constraints
-		char sense[1];			// Sign of constraint
-		char type[1];			// Type of variable (integer, binary, fractional)
-		int nonzeroes = 0;		// To calculate number of nonzero coefficients in each constraint
-		int matbeg[1];			// Begin position of the constraint
-		std::unique_ptr<int[]> matind; // Position of each element in constraint matrix
-		std::unique_ptr<double[]> matval; // Value of each element in constraint matrix
+		const int nb_zones = static_cast<int>(data.nb_zones());
 
-		matbeg[0] = 0;
+		// driving time (same order of the locations as in the model)
+		double time = data.time_driving(i, j);
 
+		if (i < nb_zones && j > nb_zones) { // i == zone, j == collection point
+			// unloading: the longest unloading time of the waste types that the truck type carries and the collection point accepts
+			double time_unloading = 0;
+			for (int t = 0; t < data.nb_waste_types(); ++t)
+			{
+				if (compatible_tq(t, q) && data.collection_point_waste_type_allowed(j - nb_zones - 1, static_cast<size_t>(t)))
+					time_unloading = std::max(time_unloading, data.time_unloading(static_cast<size_t>(t)));
+			}
+			time += time_unloading;
+		}
+		return time;
+	}
 
-		// allocate memory
-		const size_t maxnonzeroes = 100000;
-		matind = std::make_unique<int[]>(maxnonzeroes);
-		matval = std::make_unique<double[]>(maxnonzeroes);
+	void IP_model_routing::build_problem(const Instance& data, size_t day)
+	{
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = 0;
 
 
 		// create the problem
@@ -87,6 +110,11 @@ namespace IVM
 			throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change objective to minimization. \nReason: " + std::string(error_text));
 		}
 
+		// variables and constraints are staged and added in bulk
+		Model_Builder builder(env, problem, "IP_model_routing::build_problem()");
+		builder.set_batched(_batched_build);
+		builder.set_names(_model_names || _export_model);
+
 
 		// data 
 		const size_t nb_waste_types = data.nb_waste_types();
@@ -100,82 +128,136 @@ namespace IVM
 
 
 		// add variables
-		int nb_variables = -1;
+
+		// compatible waste types and truck types: a truck type only carries the waste types for which it has capacity
+		_nb_truck_types = static_cast<int>(nb_truck_types);
+		_w_block_tq.assign(nb_waste_types * nb_truck_types, -1);
+		int nb_w_blocks = 0;
+		for (int t = 0; t < nb_waste_types; ++t)
+		{
+			for (int q = 0; q < nb_truck_types; ++q)
+			{
+				if (data.capacity(static_cast<size_t>(q), static_cast<size_t>(t)) > 0)
+					_w_block_tq[t * nb_truck_types + q] = nb_w_blocks++;
+			}
+		}
 
 		// variable x_qvijk   day is given
-		const int startindex_x_qvijk = 0;
-		for (int q = 0; q < nb_truck_types; ++q)
+		// only the arcs that a route can use get a variable (see structural_arc()), 
+		// and the arcs to and from collection points that accept none of the waste types of the truck type are left out
+		auto collection_point_allowed = [&](size_t q, size_t location)
 		{
-			for (int v = 0; v < _max_nb_trucks; ++v)
+			if (location <= nb_zones) // zone or depot
+				return true;
+
+			const size_t index_cp = location - nb_zones - 1;
+			for (int t = 0; t < nb_waste_types; ++t)
 			{
-				for (int i = 0; i < nb_locations; ++i)
-				{
-					for (int j = 0; j < nb_locations; ++j)
-					{
-						for (int k = 0; k < _max_nb_segments; ++k)
-						{
-							++nb_variables;
+				if (compatible_tq(t, static_cast<int>(q)) && data.collection_point_waste_type_allowed(index_cp, static_cast<size_t>(t)))
+					return true;
+			}
+			return false;
+		};
 
-							obj[0] = 0;
-							lb[0] = 0;
-							ub[0] = 1;
-							type[0] = 'B';
+		// the arcs from a zone to a collection point that is dominated for this zone (see Instance::collection_point_dominated()) are left out too
+		auto collection_point_dominated = [&](size_t q, size_t i, size_t j)
+		{
+			if (i >= nb_zones || j <= nb_zones) // not zone - collection point
+				return false;
 
-							status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-							}
+			const size_t index_cp = j - nb_zones - 1;
+			for (int t = 0; t < nb_waste_types; ++t)
+			{
+				if (compatible_tq(t, static_cast<int>(q)) && data.collection_point_dominated(i, t, index_cp))
+					return true;
+			}
+			return false;
+		};
 
-							// change variable name
-							std::string varname = "x_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_"
-								+ std::to_string(i + 1) + "_" + std::to_string(j + 1) + "_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-							}
-						}
+		// heuristic sparsification (optional, see set_arc_sparsification()): every zone keeps the arcs to and from its
+		// _arc_k nearest usable collection points, and only the zones near the depot can be the first zone of a route
+		std::vector<bool> nearest_cp_qic(nb_truck_types * nb_zones * nb_collection_points, true);
+		if (_arc_k > 0)
+		{
+			for (int q = 0; q < nb_truck_types; ++q)
+			{
+				for (int i = 0; i < nb_zones; ++i)
+				{
+					size_t nb_kept = 0;
+					for (size_t c : data.collection_points_by_driving_time(i))
+					{
+						const size_t location = nb_zones + 1 + c;
+						const bool keep = nb_kept < _arc_k && collection_point_allowed(q, location) && !collection_point_dominated(q, i, location);
+						nearest_cp_qic[(q * nb_zones + i) * nb_collection_points + c] = keep;
+						if (keep)
+							++nb_kept;
 					}
 				}
 			}
 		}
+		const double max_time_depot = data.time_driving_zone_depot_percentile(_arc_depot_percentile);
+		auto sparse_arc_kept = [&](size_t q, size_t i, size_t j)
+		{
+			if (i == nb_zones && j < nb_zones) // depot - zone
+				return data.time_driving_zone_depot(j) <= max_time_depot;
+			if (i < nb_zones && j > nb_zones) // zone - collection point
+				return static_cast<bool>(nearest_cp_qic[(q * nb_zones + i) * nb_collection_points + (j - nb_zones - 1)]);
+			if (i > nb_zones && j < nb_zones) // collection point - zone
+				return static_cast<bool>(nearest_cp_qic[(q * nb_zones + j) * nb_collection_points + (i - nb_zones - 1)]);
+			return true;
+		};
+
+		size_t nb_dominated_arcs = 0;
+		_sparsified_arcs_q.assign(nb_truck_types, std::vector<Arc>());
+		_layout_x_qvijk = Arc_Family(0, nb_truck_types, _max_nb_trucks, nb_locations, _max_nb_segments,
+			[&](size_t q, size_t i, size_t j, size_t k)
+			{
+				if (!structural_arc(nb_zones, _max_nb_segments, i, j, k) || !collection_point_allowed(q, i) || !collection_point_allowed(q, j))
+					return false;
+				if (collection_point_dominated(q, i, j))
+				{
+					nb_dominated_arcs += _max_nb_trucks;
+					return false;
+				}
+				if (!sparse_arc_kept(q, i, j))
+				{
+					_sparsified_arcs_q[q].push_back(Arc{ static_cast<int>(i), static_cast<int>(j), static_cast<int>(k) });
+					return false;
+				}
+				return true;
+			});
+
+		for (int q = 0; q < nb_truck_types; ++q)
+		{
+			for (int v = 0; v < _max_nb_trucks; ++v)
+			{
+				for (auto&& arc : _layout_x_qvijk.arcs(q))
+				{
+					auto varname = [&] { return "x_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_"
+						+ std::to_string(arc.i + 1) + "_" + std::to_string(arc.j + 1) + "_" + std::to_string(arc.k + 1); };
+					builder.add_column(0, 0, 1, 'B', varname);
+				}
+			}
+		}
 
-		// variable w_tqvik   day is given
-		const int startindex_w_tqvik = startindex_x_qvijk + nb_truck_types * _max_nb_trucks * nb_locations * nb_locations * _max_nb_segments;
+		// variable w_tqvik   day is given (compatible t,q only)
+		const int startindex_w_tqvik = static_cast<int>(_layout_x_qvijk.end());
 		for (int t = 0; t < nb_waste_types; ++t)
 		{
 			for (int q = 0; q < nb_truck_types; ++q)
 			{
+				if (!compatible_tq(t, q))
+					continue;
+
 				for (int v = 0; v < _max_nb_trucks; ++v)
 				{
 					for (int m = 0; m < nb_zones; ++m) // enkel voor zones
 					{
 						for (int k = 0; k < _max_nb_segments; ++k)
 						{
-							++nb_variables;
-
-							obj[0] = 0;
-							lb[0] = 0;
-
-							status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-							}
-
-							// change variable name
-							std::string varname = "w_" + std::to_string(t + 1) + "_" + std::to_string(q + 1) + "_"
-								+ std::to_string(v + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-							}
+							auto varname = [&] { return "w_" + std::to_string(t + 1) + "_" + std::to_string(q + 1) + "_"
+								+ std::to_string(v + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1); };
+							builder.add_column(0, 0, CPX_INFBOUND, 'C', varname);
 						}
 					}
 				}
@@ -183,455 +265,218 @@ namespace IVM
 		}
 
 		// variable y_qv   day is given
-		const int startindex_y_qv = startindex_w_tqvik + nb_waste_types * nb_truck_types * _max_nb_trucks * nb_zones * _max_nb_segments;
+		const int startindex_y_qv = startindex_w_tqvik + nb_w_blocks * _max_nb_trucks * nb_zones * _max_nb_segments;
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
-				++nb_variables;
-
+				double obj = 0;
 				if (_include_nb_truck_objective)
-					obj[0] = data.fixed_costs(q);
-				else
-					obj[0] = 0;
-				lb[0] = 0;
-				ub[0] = 1;
-				type[0] = 'B';
-
-				status = CPXnewcols(env, problem, 1, obj, lb, ub, type, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-				}
+					obj = data.fixed_costs(q);
 
-				// change variable name
-				std::string varname = "y_" + std::to_string(q + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-				}
+				auto varname = [&] { return "y_" + std::to_string(q + 1) + "_" + std::to_string(v + 1); };
+				builder.add_column(obj, 0, 1, 'B', varname);
 			}
 		}
 
 		// variable beta_qv   day is given
-		const int startindex_beta_qv = startindex_y_qv + nb_waste_types * _max_nb_trucks;
+		const int startindex_beta_qv = startindex_y_qv + nb_truck_types * _max_nb_trucks;
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
-				++nb_variables;
-
-				obj[0] = data.operating_costs(q);
-				lb[0] = 0;
-
-				status = CPXnewcols(env, problem, 1, obj, lb, NULL, NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add variable. \nReason: " + std::string(error_text));
-				}
-
-				// change variable name
-				std::string varname = "beta_" + std::to_string(q + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'c', nb_variables, varname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change variable name. \nReason: " + std::string(error_text));
-				}
+				auto varname = [&] { return "beta_" + std::to_string(q + 1) + "_" + std::to_string(v + 1); };
+				builder.add_column(data.operating_costs(q), 0, CPX_INFBOUND, 'C', varname);
 			}
 		}
 
+		builder.flush_columns();
+
 
-		// lambdas to get variable indices
-		const int nb_segments = _max_nb_segments;
-		const int nb_trucks = _max_nb_trucks;
-		auto index_x_qvijk = [startindex_x_qvijk, nb_trucks, nb_locations, nb_segments](int q, int v, int i, int j, int k) -> int {
-			return startindex_x_qvijk + q * nb_trucks * nb_locations * nb_locations * nb_segments + v * nb_locations * nb_locations * nb_segments
-				+ i * nb_locations * nb_segments + j * nb_segments + k;
-			};
-		auto index_w_tqvik = [startindex_w_tqvik, nb_truck_types, nb_trucks, nb_zones, nb_segments](int t, int q, int v, int i_zone, int k) -> int {
-			return startindex_w_tqvik + t * nb_truck_types * nb_trucks * nb_zones * nb_segments + q * nb_trucks * nb_zones * nb_segments
-				+ v * nb_zones * nb_segments + i_zone * nb_segments + k;
-			};
-		auto index_y_qv = [startindex_y_qv, nb_trucks](int q, int v) -> int {
-			return startindex_y_qv + q * nb_trucks + v;
-			};
-		auto index_beta_qv = [startindex_beta_qv, nb_trucks](int q, int v) -> int {
-			return startindex_beta_qv + q * nb_trucks + v;
-			};
+		std::cout << "\nArc variables x_qvijk: " << _layout_x_qvijk.size() << " of " << _layout_x_qvijk.dense_size() << " (forbidden arcs not created)";
+		std::cout << "\nArc variables removed by collection point dominance: " << nb_dominated_arcs;
+		if (_arc_k > 0 || _arc_depot_percentile < 100)
+		{
+			size_t nb_sparsified_arcs = 0;
+			for (auto&& arcs : _sparsified_arcs_q)
+				nb_sparsified_arcs += arcs.size() * _max_nb_trucks;
+			std::cout << "\nArc variables removed by sparsification (heuristic, " << _arc_k << " nearest collection points, depot percentile "
+				<< _arc_depot_percentile << "): " << nb_sparsified_arcs;
+		}
+		std::cout << "\nCompatible (waste type, truck type) pairs: " << nb_w_blocks << " of " << nb_waste_types * nb_truck_types;
 
-		nb_variables = CPXgetnumcols(env, problem);
+		// layout of the variables, shared by build_problem() and solve_problem()
+		_startindex_w_tqvik = startindex_w_tqvik;
+		_startindex_y_qv = startindex_y_qv;
+		_startindex_beta_qv = startindex_beta_qv;
+		_nb_zones = static_cast<int>(nb_zones);
+		_nb_locations = static_cast<int>(nb_locations);
 
 
 
 		// add constraints
-		int nb_constraints = -1;
 
-		// 1: beta_qv - sum(i,j,k) tau_D_ij*x_qvijk - sum(t,i,k) tau_P_ti*w_tqvik - sum(i,j,k) tau_U*x_qvijk == 0   forall q,v
+		// 1: beta_qv - sum(i,j,k) tau_D_ij*x_qvijk - sum(t,i,k) tau_P_ti*w_tqvik - sum(i,j,k) tau_U_qj*x_qvijk == 0   forall q,v
+		_startindex_c1_qv = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
-				++nb_constraints;
-
-				rhs[0] = 0;
-				sense[0] = 'E';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// beta_qv
-				{
-					const size_t index = index_beta_qv(q, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
-				}
+				builder.add_coefficient(index_beta_qv(q, v), 1);
 
-				// -sum(i,j,k) (tau_D_ij + tau_U) * x_qvijk
-				for (int i = 0; i < nb_locations; ++i)
+				// -sum(i,j,k) (tau_D_ij + tau_U_qj) * x_qvijk
+				for (auto&& arc : _layout_x_qvijk.arcs(q))
 				{
-					for (int j = 0; j < nb_locations; ++j)
-					{
-						for (int k = 0; k < _max_nb_segments; ++k)
-						{
-							double coeff = 0;
-							if (i < nb_zones && j == nb_zones) { // i == zone, j == depot
-								coeff = -data.time_driving_zone_depot(i);
-							}
-							else if (i < nb_zones && j > nb_zones) { // i == zone, j == collection point
-								const std::string& cp = data.collection_point_name(j - nb_zones - 1);
-								coeff += -data.time_driving_zone_collectionpoint(i, cp);
-
-								const std::string& waste_type = data.waste_type(0); // MOMENTEEL ZELFDE VERONDERSTELD
-								coeff += -data.time_unloading(waste_type);
-							}
-							else if (i == nb_zones && j < nb_zones) { // i == depot, j == zone
-								coeff += -data.time_driving_zone_depot(j);
-							}
-							else if (i > nb_zones && j < nb_zones) { // i == collection point, j == zone
-								const std::string& cp = data.collection_point_name(i - nb_zones - 1);
-								coeff += -data.time_driving_zone_collectionpoint(j, cp);
-							}
-							else if (i > nb_zones && j == nb_zones) { // i == collection point, j == depot
-								coeff += -data.time_driving_collectionpoint_depot(i - nb_zones - 1);
-							}
-
-							const size_t index = index_x_qvijk(q, v, i, j, k);
-							if (index >= nb_variables)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-							matind[nonzeroes] = index;
-							matval[nonzeroes] = coeff;
-							++nonzeroes;
-						}
-					}
+					builder.add_coefficient(index_x_qvijk(q, v, arc.i, arc.j, arc.k), -arc_time(data, q, arc.i, arc.j));
 				}
 
 				// -sum(t,m,k) tau_P_ti*w_tqvik
 				for (int t = 0; t < nb_waste_types; ++t)
 				{
+					if (!compatible_tq(t, q))
+						continue;
+
 					for (int m = 0; m < nb_zones; ++m) // enkel zones
 					{
 						for (int k = 0; k < _max_nb_segments; ++k)
 						{
-							const size_t index = index_w_tqvik(t, q, v, m, k);
-							if (index >= nb_variables)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-							matind[nonzeroes] = index;
-							const std::string& waste_type = data.waste_type(t);
-							matval[nonzeroes] = -data.time_pickup(m, waste_type);
-							++nonzeroes;
+							const int index = index_w_tqvik(t, q, v, m, k);
+
+							builder.add_coefficient(index, -data.time_pickup(static_cast<size_t>(m), static_cast<size_t>(t)));
 						}
 					}
 				}
 
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c1_" + std::to_string(q + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c1_" + std::to_string(q + 1) + "_" + std::to_string(v + 1); };
+				builder.add_row(0, 'E', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 2: beta_qv <= T_q  forall q,v
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
-				++nb_constraints;
-
-				rhs[0] = data.max_driving_time(q);
-				sense[0] = 'L';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// beta_qv
-				{
-					const size_t index = index_beta_qv(q, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
-				}
+				builder.add_coefficient(index_beta_qv(q, v), 1);
 
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c2_" + std::to_string(q + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c2_" + std::to_string(q + 1) + "_" + std::to_string(v + 1); };
+				builder.add_row(data.max_driving_time(q), 'L', conname);
 			}
 		}
+		builder.flush_rows();
 
-		// 3: w_tqvik <= L_tq sum(j) x_qvjik   forall t,q,v,i,k
+		// 3: w_tqvik <= L_tq sum(j) x_qvjik   forall compatible t,q and v,i,k
+		_startindex_c3_tqvik = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int t = 0; t < nb_waste_types; ++t)
 		{
 			for (int q = 0; q < nb_truck_types; ++q)
 			{
+				if (!compatible_tq(t, q))
+					continue;
+
 				for (int v = 0; v < _max_nb_trucks; ++v)
 				{
 					for (int m = 0; m < nb_zones; ++m) // enkel zones
 					{
 						for (int k = 0; k < _max_nb_segments; ++k)
 						{
-							++nb_constraints;
-
-							rhs[0] = 0;
-							sense[0] = 'L';
-							matbeg[0] = 0;
-
-							nonzeroes = 0;
-
 							// w_tqvik
-							{
-								const size_t index = index_w_tqvik(t, q, v, m, k);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = 1;
-								++nonzeroes;
-							}
+							builder.add_coefficient(index_w_tqvik(t, q, v, m, k), 1);
 
 							// - L_tq sum(j) x_qvjik (aankomen bij i)
 							for(int j = 0; j < nb_locations; ++j)
 							{
-								const size_t index = index_x_qvijk(q, v, j, m, k);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
+								if (!_layout_x_qvijk.contains(q, j, m, k))
+									continue;
+								const int index = index_x_qvijk(q, v, j, m, k);
 
-								matind[nonzeroes] = index;
-								const std::string& waste_type = data.waste_type(t);
-								matval[nonzeroes] = -data.capacity(q, waste_type);
-								++nonzeroes;
+								builder.add_coefficient(index, -data.capacity(static_cast<size_t>(q), static_cast<size_t>(t)));
 							}
 
 							// - L_tq y_qv
 							/*
 							OUD
 							{
-								const size_t index = _index_y_qv(data, q, v);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
+								const int index = _index_y_qv(data, q, v);
 
-								matind[nonzeroes] = index;
 								const std::string& waste_type = data.waste_type(t);
-								matval[nonzeroes] = -data.capacity(q, waste_type);
-								++nonzeroes;
+								builder.add_coefficient(index, -data.capacity(q, waste_type));
 							}*/
 
-
-							if (nonzeroes >= maxnonzeroes)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-							status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-							}
-
-							// change name of constraint
-							std::string conname = "c3_" + std::to_string(t + 1) + "_" + std::to_string(q + 1) + "_" + std::to_string(v + 1)
-								+ "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-							}
+							auto conname = [&] { return "c3_" + std::to_string(t + 1) + "_" + std::to_string(q + 1) + "_" + std::to_string(v + 1)
+								+ "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1); };
+							builder.add_row(0, 'L', conname);
 						}
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 4. sum(q,v,k) w_tqvik == alpha_tid   forall t,i
+		_startindex_c4_ti = builder.nb_rows(); // right-hand sides change from day to day (see update_day())
 		for (int t = 0; t < nb_waste_types; ++t)
 		{
 			for (int m = 0; m < nb_zones; ++m)
 			{
-				++nb_constraints;
-
 				int dayweek = day % nb_days;
 				int week = day / nb_days; // integer division
 
-				rhs[0] = data.x_tmdw(t, m, dayweek, week);
-
-				sense[0] = 'E';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// sum(q,v,k) w_tqvik
 				for (int q = 0; q < nb_truck_types; ++q)
 				{
+					if (!compatible_tq(t, q))
+						continue;
+
 					for (int v = 0; v < _max_nb_trucks; ++v)
 					{
 						for (int k = 0; k < _max_nb_segments; ++k)
 						{
-							const size_t index = index_w_tqvik(t, q, v, m, k);
-							if (index >= nb_variables)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-							matind[nonzeroes] = index;
-							matval[nonzeroes] = 1;
-							++nonzeroes;
+							builder.add_coefficient(index_w_tqvik(t, q, v, m, k), 1);
 						}
 					}
 				}
 
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c4_" + std::to_string(t + 1) + "_" + std::to_string(m + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c4_" + std::to_string(t + 1) + "_" + std::to_string(m + 1); };
+				builder.add_row(data.x_tmdw(t, m, dayweek, week), 'E', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 5. sum(j) x_qv,depot,j,1 - y_qv == 0   forall q,v
+		_startindex_c5_qv = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
-				++nb_constraints;
-
-				rhs[0] = 0;
-				sense[0] = 'E';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// sum(j) x_qv,depot,j,1
 				for (int j = 0; j < nb_locations; ++j)
 				{
 					const int index_depot = nb_zones;
 					const int index_k = 0;
 
-					const size_t index = index_x_qvijk(q, v, index_depot, j, index_k);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = 1;
-					++nonzeroes;
+					if (_layout_x_qvijk.contains(q, index_depot, j, index_k))
+						builder.add_coefficient(index_x_qvijk(q, v, index_depot, j, index_k), 1);
 				}
 
 				// y_qv
-				{
-					const int index = index_y_qv(q, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-				}
+				builder.add_coefficient(index_y_qv(q, v), -1);
 
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
-
-				// change name of constraint
-				std::string conname = "c5_" + std::to_string(q + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c5_" + std::to_string(q + 1) + "_" + std::to_string(v + 1); };
+				builder.add_row(0, 'E', conname);
 			}
 		}
+		builder.flush_rows();
 
 		// 6. sum(j,k) x_qvi,depot,k - y_qv == 0   forall q,v
+		_startindex_c6_qv = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
-				++nb_constraints;
-
-				rhs[0] = 0;
-				sense[0] = 'E';
-				matbeg[0] = 0;
-
-				nonzeroes = 0;
-
 				// sum(j,k) x_qvi,depot,k
 				for (int i = 0; i < nb_locations; ++i)
 				{
@@ -639,162 +484,25 @@ namespace IVM
 					{
 						const int index_depot = nb_zones;
 
-						const size_t index = index_x_qvijk(q, v, i, index_depot, k);
-						if (index >= nb_variables)
-							throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-						matind[nonzeroes] = index;
-						matval[nonzeroes] = 1;
-						++nonzeroes;
+						if (_layout_x_qvijk.contains(q, i, index_depot, k))
+							builder.add_coefficient(index_x_qvijk(q, v, i, index_depot, k), 1);
 					}
 				}
 
 				// y_qv
-				{
-					const size_t index = index_y_qv(q, v);
-					if (index >= nb_variables)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-					matind[nonzeroes] = index;
-					matval[nonzeroes] = -1;
-					++nonzeroes;
-				}
-
-				if (nonzeroes >= maxnonzeroes)
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-				status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-				}
+				builder.add_coefficient(index_y_qv(q, v), -1);
 
-				// change name of constraint
-				std::string conname = "c6_" + std::to_string(q + 1) + "_" + std::to_string(v + 1);
-				status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-				if (status != 0)
-				{
-					CPXgeterrorstring(env, status, error_text);
-					throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-				}
+				auto conname = [&] { return "c6_" + std::to_string(q + 1) + "_" + std::to_string(v + 1); };
+				builder.add_row(0, 'E', conname);
 			}
 		}
+		builder.flush_rows();
 
-		// 7. x_qvijk == 0   for zone-zone or dropoff-dropoff
-		for (int q = 0; q < nb_truck_types; ++q)
-		{
-			for (int v = 0; v < _max_nb_trucks; ++v)
-			{
-				for (int i = 0; i < nb_locations; ++i)
-				{
-					for (int j = 0; j < nb_locations; ++j)
-					{
-						for (int k = 0; k < _max_nb_segments; ++k)
-						{
-							// forbidden combinations
-							if ((i < nb_zones && j < nb_zones)       // zone - zone
-								|| (i > nb_zones && j > nb_zones)    // dropoff - dropoff
-								|| (i == nb_zones && j == nb_zones)  // depot - depot
-								|| (i == nb_zones && j > nb_zones)   // depot - dropoff (dropoff-depot however is possible)
-								|| (i < nb_zones && j == nb_zones)   // zone - depot (always first to dropoff)
-								|| (i == nb_zones && k > 0)) // depot-zone if not first segment
-							{
-								++nb_constraints;
-
-								rhs[0] = 0;
-								sense[0] = 'E';
-								matbeg[0] = 0;
-
-								nonzeroes = 0;
-
-								// x_qvijk
-								{
-									const size_t index = index_x_qvijk(q, v, i, j, k);
-									if (index >= nb_variables)
-										throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-									matind[nonzeroes] = index;
-									matval[nonzeroes] = 1;
-									++nonzeroes;
-								}
-
-								if (nonzeroes >= maxnonzeroes)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-								status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-								if (status != 0)
-								{
-									CPXgeterrorstring(env, status, error_text);
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-								}
-
-								// change name of constraint
-								std::string conname = "c7_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1) + "_"
-									+ std::to_string(j + 1) + "_" + std::to_string(k + 1);
-								status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-								if (status != 0)
-								{
-									CPXgeterrorstring(env, status, error_text);
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-								}
-							}
-
-							// forbidden dropoffs at collection points
-							if (j > nb_zones)
-							{
-								int index_cp = j - nb_zones - 1;
-								auto& truck_name = data.truck_type(q);
-								if ((truck_name == "truck_GFT" && !data.collection_point_waste_type_allowed(index_cp, "GFT"))
-									|| (truck_name == "truck_restafval" && !data.collection_point_waste_type_allowed(index_cp, "restafval")))
-								{
-									++nb_constraints;
-
-									rhs[0] = 0;
-									sense[0] = 'E';
-									matbeg[0] = 0;
-
-									nonzeroes = 0;
-
-									// x_qvijk
-									{
-										const size_t index = index_x_qvijk(q, v, i, j, k);
-										if (index >= nb_variables)
-											throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-										matind[nonzeroes] = index;
-										matval[nonzeroes] = 1;
-										++nonzeroes;
-									}
-
-									if (nonzeroes >= maxnonzeroes)
-										throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-									status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-									}
-
-									// change name of constraint
-									std::string conname = "c7_dropoffs_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1) + "_"
-										+ std::to_string(j + 1) + "_" + std::to_string(k + 1);
-									status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-									}
-								}
-							}
-						}
-					}
-				}
-			}
-		}
+		// 7. x_qvijk == 0   for zone-zone, dropoff-dropoff, forbidden dropoffs at collection points, ...
+		//    these arcs have no variable (see build of x_qvijk above)
 
 		// 8. sum(j) x_qvij,k+1 - sum(j) x_qvjik == 0   forall q,v,i!=depot,k
+		_rowindex_c8_qvik.assign(nb_truck_types * _max_nb_trucks * nb_locations * _max_nb_segments, -1);
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
@@ -805,187 +513,141 @@ namespace IVM
 					{
 						for (int k = 0; k < _max_nb_segments - 1; ++k)
 						{
-							++nb_constraints;
-
-							rhs[0] = 0;
-							sense[0] = 'E';
-							matbeg[0] = 0;
-
-							nonzeroes = 0;
+							bool empty = true;
 
 							// sum(j) x_qvij,k+1
 							for (int j = 0; j < nb_locations; ++j)
 							{
-								const size_t index = index_x_qvijk(q, v, i, j, k + 1);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = 1;
-								++nonzeroes;
+								if (_layout_x_qvijk.contains(q, i, j, k + 1))
+								{
+									builder.add_coefficient(index_x_qvijk(q, v, i, j, k + 1), 1);
+									empty = false;
+								}
 							}
 
 							// sum(j) x_qvjik
 							for (int j = 0; j < nb_locations; ++j)
 							{
-								const size_t index = index_x_qvijk(q, v, j, i, k);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = -1;
-								++nonzeroes;
+								if (_layout_x_qvijk.contains(q, j, i, k))
+								{
+									builder.add_coefficient(index_x_qvijk(q, v, j, i, k), -1);
+									empty = false;
+								}
 							}
 
-							if (nonzeroes >= maxnonzeroes)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-							status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-							}
+							if (empty)
+								continue;
 
-							// change name of constraint
-							std::string conname = "c8_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1) + "_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-							}
+							_rowindex_c8_qvik[((q * _max_nb_trucks + v) * nb_locations + i) * _max_nb_segments + k] = builder.nb_rows();
+							auto conname = [&] { return "c8_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1) + "_" + std::to_string(k + 1); };
+							builder.add_row(0, 'E', conname);
 						}
 					}
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 9. sum(i,j) x_qvijk <= 1   forall q,v,k
+		_startindex_c9_qvk = builder.nb_rows(); // used to price the arcs left out by sparsification
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
 				for (int k = 0; k < _max_nb_segments; ++k)
 				{
-					++nb_constraints;
-
-					rhs[0] = 1;
-					sense[0] = 'L'; 
-					matbeg[0] = 0;
-
-					nonzeroes = 0;
-
 					// sum(i,j) x_qvijk
 					for (int i = 0; i < nb_locations; ++i)
 					{
 						for (int j = 0; j < nb_locations; ++j)
 						{
-							const size_t index = index_x_qvijk(q, v, i, j, k);
-							if (index >= nb_variables)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-							matind[nonzeroes] = index;
-							matval[nonzeroes] = 1;
-							++nonzeroes;
+							if (_layout_x_qvijk.contains(q, i, j, k))
+								builder.add_coefficient(index_x_qvijk(q, v, i, j, k), 1);
 						}
 					}
 
-					if (nonzeroes >= maxnonzeroes)
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
-
-					status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-					}
-
-					// change name of constraint
-					std::string conname = "c9_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(k + 1);
-					status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-					if (status != 0)
-					{
-						CPXgeterrorstring(env, status, error_text);
-						throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-					}
+					auto conname = [&] { return "c9_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(k + 1); };
+					builder.add_row(1, 'L', conname);
 				}
 			}
 		}
+		builder.flush_rows();
 
 		// 10. x_qvijk - y_qv <= 0   forall q,v,i,j,k
 		for (int q = 0; q < nb_truck_types; ++q)
 		{
 			for (int v = 0; v < _max_nb_trucks; ++v)
 			{
-				for (int i = 0; i < nb_locations; ++i)
+				for (auto&& arc : _layout_x_qvijk.arcs(q))
 				{
-					for (int j = 0; j < nb_locations; ++j)
-					{
-						for (int k = 0; k < _max_nb_segments; ++k)
-						{
-							++nb_constraints;
+					// x_qvijk
+					builder.add_coefficient(index_x_qvijk(q, v, arc.i, arc.j, arc.k), 1);
 
-							rhs[0] = 0;
-							sense[0] = 'L';
-							matbeg[0] = 0;
+					// - y_qv
+					builder.add_coefficient(index_y_qv(q, v), -1);
 
-							nonzeroes = 0;
+					auto conname = [&] { return "c10_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(arc.i + 1)
+						+ "_" + std::to_string(arc.j + 1) +"_" + std::to_string(arc.k + 1); };
+					builder.add_row(0, 'L', conname);
+				}
+			}
+		}
+		builder.flush_rows();
 
-							// x_qvijk
-							{
-								const size_t index = index_x_qvijk(q, v, i, j, k);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
-
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = 1;
-								++nonzeroes;
-							}
+		// Symmetry breaking (optional): the trucks of the same type are identical
+		// 1. y_q,v+1 - y_qv <= 0   forall q,v: the used trucks of a type come first
+		if (_symmetry_breaking >= SYMMETRY_ORDER_TRUCKS)
+		{
+			for (int q = 0; q < nb_truck_types; ++q)
+			{
+				for (int v = 0; v < _max_nb_trucks - 1; ++v) // niet laatste
+				{
+					// y_q,v+1
+					builder.add_coefficient(index_y_qv(q, v + 1), 1);
 
-							// - y_qv
-							{
-								const size_t index = index_y_qv(q, v);
-								if (index >= nb_variables)
-									throw std::runtime_error("Error in function IP_model_routing::build_problem(). Index variable exceeds range");
+					// -y_qv
+					builder.add_coefficient(index_y_qv(q, v), -1);
 
-								matind[nonzeroes] = index;
-								matval[nonzeroes] = -1;
-								++nonzeroes;
-							}
+					auto conname = [&] { return "symmetry_breaking_c1_" + std::to_string(q + 1) + "_" + std::to_string(v + 1); };
+					builder.add_row(0, 'L', conname);
+				}
+			}
+			builder.flush_rows();
+		}
 
-							if (nonzeroes >= maxnonzeroes)
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). Nonzeroes exceeds size of maxnonzeroes (matind and matval)");
+		// 2. beta_q,v+1 - beta_qv <= 0   forall q,v: the used trucks of a type are sorted by route duration (beta_qv == 0 for an unused truck)
+		if (_symmetry_breaking >= SYMMETRY_ORDER_DURATION)
+		{
+			for (int q = 0; q < nb_truck_types; ++q)
+			{
+				for (int v = 0; v < _max_nb_trucks - 1; ++v) // niet laatste
+				{
+					// beta_q,v+1
+					builder.add_coefficient(index_beta_qv(q, v + 1), 1);
 
-							status = CPXaddrows(env, problem, 0, 1, nonzeroes, rhs, sense, matbeg, matind.get(), matval.get(), NULL, NULL);
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't add constraint. \nReason: " + std::string(error_text));
-							}
+					// -beta_qv
+					builder.add_coefficient(index_beta_qv(q, v), -1);
 
-							// change name of constraint
-							std::string conname = "c10_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_" + std::to_string(i + 1)
-								+ "_" + std::to_string(j + 1) +"_" + std::to_string(k + 1);
-							status = CPXchgname(env, problem, 'r', nb_constraints, conname.c_str());
-							if (status != 0)
-							{
-								CPXgeterrorstring(env, status, error_text);
-								throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't change constraint name. \nReason: " + std::string(error_text));
-							}
-						}
-					}
+					auto conname = [&] { return "symmetry_breaking_c2_" + std::to_string(q + 1) + "_" + std::to_string(v + 1); };
+					builder.add_row(0, 'L', conname);
 				}
 			}
+			builder.flush_rows();
 		}
 
+		builder.print_statistics();
 
-		// write to file
-		status = CPXwriteprob(env, problem, "IP_model_routing.lp", NULL);
-		if (status != 0)
+
+		// write to file (only on request, as compressed SAV file)
+		if (_export_model)
 		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't write problem to lp-file. \nReason: " + std::string(error_text));
+			std::string filename = "IP_model_routing_day" + std::to_string(day + 1) + ".sav.gz";
+			status = CPXwriteprob(env, problem, filename.c_str(), NULL);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_routing::build_problem(). \nCouldn't write problem to sav-file. \nReason: " + std::string(error_text));
+			}
 		}
 	}
 
@@ -997,12 +659,8 @@ namespace IVM
 		std::unique_ptr<double[]> solution_problem;
 		double objval;
 
-		status = CPXreadcopyprob(env, problem, "IP_model_routing.lp", NULL); /// Dit werkt wel, maar probleem rechtstreeks geeft error
-		if (status != 0)
-		{
-			CPXgeterrorstring(env, status, error_text);
-			throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't read problem from lp-file. \nReason: " + std::string(error_text));
-		}
+		// Output of this day (written to the files by write_day_output())
+		_day_output = Day_Output();
 
 		// Set allowed computation time
 		status = CPXsetdblparam(env, CPXPARAM_TimeLimit, _max_computation_time);
@@ -1028,6 +686,17 @@ namespace IVM
 			throw std::runtime_error("Error in function IP_model_allocation::solve_problem(). \nCouldn't set search strategy. \nReason: " + std::string(error_text));
 		}
 
+		// Symmetry breaking by CPLEX (most aggressive level, includes orbital fixing)
+		if (_symmetry_breaking >= SYMMETRY_ORDER_AND_CPLEX)
+		{
+			status = CPXsetintparam(env, CPXPARAM_Preprocessing_Symmetry, 5);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't set symmetry breaking. \nReason: " + std::string(error_text));
+			}
+		}
+
 		// Assign memory for solution
 		const int numvar = CPXgetnumcols(env, problem);
 		solution_problem = std::make_unique<double[]>(numvar);
@@ -1036,6 +705,16 @@ namespace IVM
 		std::cout << "\n\nSolving the routing problem for day " << day + 1;
 		auto start_time = std::chrono::system_clock::now();
 
+		// Register when the first feasible solution is found
+		Incumbent_Log incumbent_log;
+		incumbent_log.start_time = start_time;
+		status = CPXsetinfocallbackfunc(env, incumbent_callback, &incumbent_log);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't set info callback. \nReason: " + std::string(error_text));
+		}
+
 		status = CPXmipopt(env, problem);
 		if (status != 0)
 		{
@@ -1045,6 +724,13 @@ namespace IVM
 
 		std::chrono::duration<double, std::ratio<1, 1>> elapsed_time_IP = std::chrono::system_clock::now() - start_time;
 
+		status = CPXsetinfocallbackfunc(env, NULL, NULL);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't remove info callback. \nReason: " + std::string(error_text));
+		}
+
 
 		// Get the solution
 		status = CPXsolution(env, problem, &solstat, &objval, solution_problem.get(), NULL, NULL, NULL);
@@ -1063,106 +749,90 @@ namespace IVM
 			if (solstat == CPXMIP_OPTIMAL || solstat == CPXMIP_OPTIMAL_TOL || solstat == CPXMIP_TIME_LIM_FEAS)
 			{
 				_objective_value = objval;
+				_day_output.solved = true;
+				_day_output.objective_value = objval;
+				_day_output.time_first_incumbent = incumbent_log.time_first_incumbent;
+				if (CPXgetmiprelgap(env, problem, &_day_output.gap) != 0)
+					_day_output.gap = -1;
 				std::cout << "\nObjective value = " << objval;
 				std::cout << "\nElapsed time (s): " << elapsed_time_IP.count();
+				std::cout << "\nTime to first incumbent (s): " << _day_output.time_first_incumbent;
+				std::cout << "\nFinal gap: " << _day_output.gap;
 				const size_t nb_waste_types = data.nb_waste_types();
 				const size_t nb_truck_types = data.nb_truck_types();
 				const size_t nb_zones = data.nb_zones();
 				const size_t nb_days = data.nb_days();
-				const size_t nb_weeks = data.nb_weeks();
-				const size_t nb_collection_points = data.nb_collection_points();
-				const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
 
 				// Obtain values for variables
-				std::vector<int> y_qv, x_qvijk;
-				std::vector<double> w_tqvik, beta_qv;
+				// (directly via their column indices; per truck, only the nonzero x and w variables are visited)
+				Solution_View solution(solution_problem.get(), numvar);
+
+				// Keep the nonzero variables (MIP start for the other days)
+				for (auto&& var : solution.nonzeroes(0, numvar, 1e-6))
+				{
+					_day_output.solution_indices.push_back(var.index);
+					_day_output.solution_values.push_back(var.value);
+				}
+
+				struct Arc
+				{
+					int k, i, j;	// segment, origin, destination
+				};
+				struct Pickup
+				{
+					int t, m, k;	// waste type, zone, segment
+					double amount;
+				};
+
+				std::vector<int> y_qv;
+				std::vector<double> beta_qv;
+				std::vector<std::vector<Arc>> arcs_qv(nb_truck_types * _max_nb_trucks);			// ordered by segment
+				std::vector<std::vector<Pickup>> pickups_qv(nb_truck_types * _max_nb_trucks);	// ordered by waste type, zone and segment
 
 				y_qv.reserve(nb_truck_types * _max_nb_trucks);
-				x_qvijk.reserve(nb_truck_types * _max_nb_trucks * nb_locations * nb_locations * _max_nb_segments);
-				w_tqvik.reserve(nb_waste_types * nb_truck_types * _max_nb_trucks * nb_zones * _max_nb_segments);
 				beta_qv.reserve(nb_truck_types * _max_nb_trucks);
 
-				// x variables
+				// y variables and beta variables
 				for (int q = 0; q < nb_truck_types; ++q) {
 					for (int v = 0; v < _max_nb_trucks; ++v) {
-						for (int i = 0; i < nb_locations; ++i) {
-							for (int j = 0; j < nb_locations; ++j) {
-								for (int k = 0; k < _max_nb_segments; ++k) {
-
-									std::string varname = "x_" + std::to_string(q + 1) + "_" + std::to_string(v + 1) + "_"
-										+ std::to_string(i + 1) + "_" + std::to_string(j + 1) + "_" + std::to_string(k + 1);
-
-									int index;
-									status = CPXgetcolindex(env, problem, varname.c_str(), &index);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't access variable. \nReason: " + std::string(error_text));
-									}
+						y_qv.push_back(solution.integer_value(index_y_qv(q, v)));
+						beta_qv.push_back(solution.value(index_beta_qv(q, v)));
+					}
+				}
 
-									int x = static_cast<int>(solution_problem[index] + 0.1);
-									x_qvijk.push_back(x);
-								}
-							}
+				// x variables (binary, so values below 0.5 are zero)
+				const int nb_segments = static_cast<int>(_max_nb_segments);
+				for (int q = 0; q < nb_truck_types; ++q) {
+					for (int v = 0; v < _max_nb_trucks; ++v) {
+						auto& arcs = arcs_qv[q * _max_nb_trucks + v];
+						const Column_Range columns = _layout_x_qvijk.slice(q, v);
+						const auto& allowed_arcs = _layout_x_qvijk.arcs(q);
+						for (auto&& x : solution.nonzeroes(static_cast<int>(columns.first), static_cast<int>(columns.last), 0.5)) {
+							const IVM::Arc& arc = allowed_arcs[x.index - columns.first];
+							arcs.push_back(Arc{ arc.k, arc.i, arc.j });
 						}
+						std::sort(arcs.begin(), arcs.end(), [](const Arc& a, const Arc& b) {
+							return std::tie(a.k, a.i, a.j) < std::tie(b.k, b.i, b.j);
+							});
 					}
 				}
 
 				// w variables
 				for (int t = 0; t < nb_waste_types; ++t) {
 					for (int q = 0; q < nb_truck_types; ++q) {
+						if (!compatible_tq(t, q))
+							continue;
 						for (int v = 0; v < _max_nb_trucks; ++v) {
-							for (int m = 0; m < nb_zones; ++m) { // enkel zones
-								for (int k = 0; k < _max_nb_segments; ++k) {
-
-									std::string varname = "w_" + std::to_string(t + 1) + "_" + std::to_string(q + 1) + "_"
-										+ std::to_string(v + 1) + "_" + std::to_string(m + 1) + "_" + std::to_string(k + 1);
-
-									int index;
-									status = CPXgetcolindex(env, problem, varname.c_str(), &index);
-									if (status != 0)
-									{
-										CPXgeterrorstring(env, status, error_text);
-										throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't access variable. \nReason: " + std::string(error_text));
-									}
-
-									double w = solution_problem[index];
-									w_tqvik.push_back(w);
-								}
+							const int begin = index_w_tqvik(t, q, v, 0, 0);
+							const int end = begin + static_cast<int>(nb_zones) * nb_segments;
+							for (auto&& w : solution.nonzeroes(begin, end)) {
+								const int offset = w.index - begin;
+								pickups_qv[q * _max_nb_trucks + v].push_back(Pickup{ t, offset / nb_segments, offset % nb_segments, w.value });
 							}
 						}
 					}
 				}
 
-				// y variables and beta variables
-				for (int q = 0; q < nb_truck_types; ++q) {
-					for (int v = 0; v < _max_nb_trucks; ++v) {
-
-						std::string varname_y = "y_" + std::to_string(q + 1) + "_" + std::to_string(v + 1);
-						int index_y;
-						status = CPXgetcolindex(env, problem, varname_y.c_str(), &index_y);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't access variable. \nReason: " + std::string(error_text));
-						}
-						double y = solution_problem[index_y];
-						y_qv.push_back(static_cast<int>(y + 0.0001));
-
-
-						std::string varname_beta = "beta_" + std::to_string(q + 1) + "_" + std::to_string(v + 1);
-						int index_beta;
-						status = CPXgetcolindex(env, problem, varname_beta.c_str(), &index_beta);
-						if (status != 0)
-						{
-							CPXgeterrorstring(env, status, error_text);
-							throw std::runtime_error("Error in function IP_model_routing::solve_problem(). \nCouldn't access variable. \nReason: " + std::string(error_text));
-						}
-						double beta = solution_problem[index_beta];
-						beta_qv.push_back(beta);
-					}
-				}
-
 				// fixed and variable costs trucks
 				double fixed_costs = 0, variable_costs = 0;
 				for (int q = 0; q < nb_truck_types; ++q)
@@ -1183,12 +853,7 @@ namespace IVM
 				{
 					try
 					{
-						std::ofstream solfile;
-						std::string filename = data.name_instance() + "_routing.txt";
-						if (day == 0)
-							solfile.open(filename);
-						else
-							solfile.open(filename, std::ios_base::app); // append
+						std::ostringstream solfile; // written to <instance>_routing.txt by write_day_output()
 
 						if (day == 0)
 						{
@@ -1197,6 +862,8 @@ namespace IVM
 							solfile << "\nMax nb trucks (per type): " << _max_nb_trucks;
 							solfile << "\nMax nb segments per route: " << _max_nb_segments;
 							solfile << "\nInclude truck objective: "; if (_include_nb_truck_objective) solfile << "yes"; else solfile << "no";
+							if (_arc_k > 0 || _arc_depot_percentile < 100)
+								solfile << "\nArc sparsification (heuristic): " << _arc_k << " nearest collection points, depot percentile " << _arc_depot_percentile;
 						}
 
 						solfile << "\n\n\n\nDay " << day + 1;
@@ -1210,48 +877,43 @@ namespace IVM
 									solfile << "\n\nVrachtwagen type " << data.truck_type(q) << ", nummer " << v + 1; //<< ": y = " << y_qv[q * _max_nb_trucks + v];
 									solfile << "\nRijtijd: " << beta_qv.at(q * _max_nb_trucks + v);
 									solfile << "\nOphalingen:";
-									for (int t = 0; t < nb_waste_types; ++t) {
-										for (int m = 0; m < nb_zones; ++m) {
-											for (int k = 0; k < _max_nb_segments; ++k) {
-												double wval = w_tqvik.at(t * nb_truck_types * _max_nb_trucks * nb_zones * _max_nb_segments + q * _max_nb_trucks * nb_zones * _max_nb_segments + v * nb_zones * _max_nb_segments + m * _max_nb_segments + k);
-												if (wval > 0) {
-													solfile << "\n\t" << data.zone_name(m) << ", " << data.waste_type(t)
-														<< ", segment " << k + 1 << ", hoeveelheid = " << wval;
-												}
-											}
+									for (auto&& pickup : pickups_qv[q * _max_nb_trucks + v]) {
+										const int t = pickup.t;
+										const int m = pickup.m;
+										const int k = pickup.k;
+										double wval = pickup.amount;
+										if (wval > 0) {
+											solfile << "\n\t" << data.zone_name(m) << ", " << data.waste_type(t)
+												<< ", segment " << k + 1 << ", hoeveelheid = " << wval;
 										}
 									}
 									solfile << "\nRoute:";
-									for (int k = 0; k < _max_nb_segments; ++k) {
-										for (int i = 0; i < nb_locations; ++i) {
-											for (int j = 0; j < nb_locations; ++j) {
-												int xval = x_qvijk.at(q * _max_nb_trucks * nb_locations * nb_locations * _max_nb_segments + v * nb_locations * nb_locations * _max_nb_segments + i * nb_locations * _max_nb_segments + j * _max_nb_segments + k);
-												if (xval > 0) {
-													std::string origin, destination;
-													if (i < nb_zones)
-														origin = data.zone_name(i);
-													else if (i == nb_zones)
-														origin = "depot";
-													else
-														origin = data.collection_point_name(i - nb_zones - 1);
-													if (j < nb_zones)
-														destination = data.zone_name(j);
-													else if (j == nb_zones)
-														destination = "depot";
-													else
-														destination = data.collection_point_name(j - nb_zones - 1);
-
-													solfile << "\n\tsegment " << k + 1 << ": van " << origin << " naar " << destination;
-												}
-											}
-										}
+									for (auto&& arc : arcs_qv[q * _max_nb_trucks + v]) {
+										const int i = arc.i;
+										const int j = arc.j;
+										const int k = arc.k;
+										std::string origin, destination;
+										if (i < nb_zones)
+											origin = data.zone_name(i);
+										else if (i == nb_zones)
+											origin = "depot";
+										else
+											origin = data.collection_point_name(i - nb_zones - 1);
+										if (j < nb_zones)
+											destination = data.zone_name(j);
+										else if (j == nb_zones)
+											destination = "depot";
+										else
+											destination = data.collection_point_name(j - nb_zones - 1);
+
+										solfile << "\n\tsegment " << k + 1 << ": van " << origin << " naar " << destination;
 									}
 								}
 							}
 						}
 
 						solfile << "\n\n====================================================================================================\n\n\n\n\n\n\n\n\n\n\n";
-						solfile.flush();
+						_day_output.routing = solfile.str();
 					}
 					catch (const std::exception& e)
 					{
@@ -1269,12 +931,7 @@ namespace IVM
 				{
 					try
 					{
-						std::ofstream solfile;
-						std::string filename = data.name_instance() + "_routing_alt.txt";
-						if (day == 0)
-							solfile.open(filename);
-						else
-							solfile.open(filename, std::ios_base::app); // append
+						std::ostringstream solfile; // written to <instance>_routing_alt.txt by write_day_output()
 
 						if (day == 0)
 						{
@@ -1312,36 +969,27 @@ namespace IVM
 									newroute.trucktype = data.truck_type(q);
 									newroute.hours = beta_qv.at(q * _max_nb_trucks + v);
 
-									for (int t = 0; t < nb_waste_types; ++t) {
-										for (int m = 0; m < nb_zones; ++m) {
-											for (int k = 0; k < _max_nb_segments; ++k) {
-												double wval = w_tqvik.at(t * nb_truck_types * _max_nb_trucks * nb_zones * _max_nb_segments + q * _max_nb_trucks * nb_zones * _max_nb_segments + v * nb_zones * _max_nb_segments + m * _max_nb_segments + k);
-												if (wval > 0.001) {
-													newroute.wastetype = data.waste_type(t);
-													int wvalkg = static_cast<int>(wval * 1000 + 0.001);
-													newroute.amounts.push_back(wvalkg);
-												}
-											}
+									for (auto&& pickup : pickups_qv[q * _max_nb_trucks + v]) {
+										const int t = pickup.t;
+										double wval = pickup.amount;
+										if (wval > 0.001) {
+											newroute.wastetype = data.waste_type(t);
+											int wvalkg = static_cast<int>(wval * 1000 + 0.001);
+											newroute.amounts.push_back(wvalkg);
 										}
 									}
 
-									for (int k = 0; k < _max_nb_segments; ++k) {
-										for (int i = 0; i < nb_locations; ++i) {
-											for (int j = 0; j < nb_locations; ++j) {
-												int xval = x_qvijk.at(q * _max_nb_trucks * nb_locations * nb_locations * _max_nb_segments + v * nb_locations * nb_locations * _max_nb_segments + i * nb_locations * _max_nb_segments + j * _max_nb_segments + k);
-												if (xval > 0) {
-													std::string destination;
-													if (j < nb_zones)
-														destination = data.zone_name(j);
-													else if (j == nb_zones)
-														destination = "depot";
-													else
-														destination = data.collection_point_name(j - nb_zones - 1);
-
-													newroute.destinations.push_back(destination);
-												}
-											}
-										}
+									for (auto&& arc : arcs_qv[q * _max_nb_trucks + v]) {
+										const int j = arc.j;
+										std::string destination;
+										if (j < nb_zones)
+											destination = data.zone_name(j);
+										else if (j == nb_zones)
+											destination = "depot";
+										else
+											destination = data.collection_point_name(j - nb_zones - 1);
+
+										newroute.destinations.push_back(destination);
 									}
 
 									// check if route already exists
@@ -1378,7 +1026,7 @@ namespace IVM
 							}
 							solfile << "\t" << r.nb_times_used;
 						}
-						solfile.flush();
+						_day_output.routing_alt = solfile.str();
 					}
 					catch (const std::exception& e)
 					{
@@ -1397,19 +1045,9 @@ namespace IVM
 				{
 					try
 					{
-						std::ofstream solfile;
-						std::string filename = data.name_instance() + "_routing_altshort.txt";
-						if (day == 0)
-							solfile.open(filename);
-						else
-							solfile.open(filename, std::ios_base::app); // append
+						std::ostringstream solfile; // written to <instance>_routing_altshort.txt by write_day_output()
 
-						std::ofstream truckfile;
-						filename = data.name_instance() + "_trucks.txt";
-						if (day == 0)
-							truckfile.open(filename);
-						else
-							truckfile.open(filename, std::ios_base::app); // append
+						std::ostringstream truckfile; // written to <instance>_trucks.txt by write_day_output()
 
 						if (day == 0)
 						{
@@ -1442,23 +1080,17 @@ namespace IVM
 									newroute.destinations.push_back("depot");
 									newroute.trucktype = data.truck_type(q);
 
-									for (int k = 0; k < _max_nb_segments; ++k) {
-										for (int i = 0; i < nb_locations; ++i) {
-											for (int j = 0; j < nb_locations; ++j) {
-												int xval = x_qvijk.at(q * _max_nb_trucks * nb_locations * nb_locations * _max_nb_segments + v * nb_locations * nb_locations * _max_nb_segments + i * nb_locations * _max_nb_segments + j * _max_nb_segments + k);
-												if (xval > 0) {
-													std::string destination;
-													if (j < nb_zones)
-														destination = data.zone_name(j);
-													else if (j == nb_zones)
-														destination = "depot";
-													else
-														destination = data.collection_point_name(j - nb_zones - 1);
-
-													newroute.destinations.push_back(destination);
-												}
-											}
-										}
+									for (auto&& arc : arcs_qv[q * _max_nb_trucks + v]) {
+										const int j = arc.j;
+										std::string destination;
+										if (j < nb_zones)
+											destination = data.zone_name(j);
+										else if (j == nb_zones)
+											destination = "depot";
+										else
+											destination = data.collection_point_name(j - nb_zones - 1);
+
+										newroute.destinations.push_back(destination);
 									}
 
 									// check if route already exists
@@ -1489,7 +1121,7 @@ namespace IVM
 							}
 							solfile << "\t" << r.nb_times_used;
 						}
-						solfile.flush();
+						_day_output.routing_altshort = solfile.str();
 
 						int tottrucks = 0;
 						for (auto&& r : routes) {
@@ -1497,7 +1129,7 @@ namespace IVM
 						}
 
 						truckfile << "\n" << day + 1 << " " << tottrucks;
-						truckfile.flush();
+						_day_output.trucks = truckfile.str();
 					}
 					catch (const std::exception& e)
 					{
@@ -1532,30 +1164,21 @@ namespace IVM
 									Route newroute;
 									newroute.trucktype = data.truck_type(q);
 
-									for (int t = 0; t < nb_waste_types; ++t) {
-										for (int m = 0; m < nb_zones; ++m) {
-											for (int k = 0; k < _max_nb_segments; ++k) {
-												double wval = w_tqvik.at(t * nb_truck_types * _max_nb_trucks * nb_zones * _max_nb_segments + q * _max_nb_trucks * nb_zones * _max_nb_segments + v * nb_zones * _max_nb_segments + m * _max_nb_segments + k);
-												if (wval > 0.001) {
-													newroute.wastetype = data.waste_type(t);
-													break;
-												}
-											}
+									for (auto&& pickup : pickups_qv[q * _max_nb_trucks + v]) {
+										const int t = pickup.t;
+										double wval = pickup.amount;
+										if (wval > 0.001) {
+											newroute.wastetype = data.waste_type(t);
+											break;
 										}
 									}
 
-									for (int k = 0; k < _max_nb_segments; ++k) {
-										for (int i = 0; i < nb_locations; ++i) {
-											for (int j = 0; j < nb_locations; ++j) {
-												int xval = x_qvijk.at(q * _max_nb_trucks * nb_locations * nb_locations * _max_nb_segments + v * nb_locations * nb_locations * _max_nb_segments + i * nb_locations * _max_nb_segments + j * _max_nb_segments + k);
-												if (xval > 0) {
-													std::string destination;
-													if (j < nb_zones) { // Only zones
-														destination = data.zone_name(j);
-														newroute.destinations.push_back(destination);
-													}
-												}
-											}
+									for (auto&& arc : arcs_qv[q * _max_nb_trucks + v]) {
+										const int j = arc.j;
+										std::string destination;
+										if (j < nb_zones) { // Only zones
+											destination = data.zone_name(j);
+											newroute.destinations.push_back(destination);
 										}
 									}
 
@@ -1580,12 +1203,7 @@ namespace IVM
 
 
 
-						std::ofstream solfile;
-						std::string filename = data.name_instance() + "_routes.xml";
-						if (day == 0)
-							solfile.open(filename);
-						else
-							solfile.open(filename, std::ios_base::app); // append
+						std::ostringstream solfile; // written to <instance>_routes.xml by write_day_output()
 
 						if (day == 0)
 						{
@@ -1620,7 +1238,7 @@ namespace IVM
 							solfile << "\n</Routes>";
 
 
-						solfile.flush();
+						_day_output.routes_xml = solfile.str();
 					}
 					catch (const std::exception& e)
 					{
@@ -1635,6 +1253,101 @@ namespace IVM
 
 	}
 
+	void IP_model_routing::price_sparsified_arcs(const Instance& data)
+	{
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = 0;
+
+		const int nb_truck_types = _nb_truck_types;
+		const int nb_trucks = static_cast<int>(_max_nb_trucks);
+		const int nb_segments = static_cast<int>(_max_nb_segments);
+		const int nb_zones = _nb_zones;
+		const int nb_locations = _nb_locations;
+		const int index_depot = nb_zones;
+
+		// Duals of the LP relaxation of the sparse model
+		CPXLPptr relaxation = CPXcloneprob(env, problem, &status);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_routing::price_sparsified_arcs(). \nCouldn't copy problem. \nReason: " + std::string(error_text));
+		}
+
+		status = CPXchgprobtype(env, relaxation, CPXPROB_LP);
+		if (status == 0)
+			status = CPXlpopt(env, relaxation);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			CPXfreeprob(env, &relaxation);
+			throw std::runtime_error("Error in function IP_model_routing::price_sparsified_arcs(). \nCouldn't solve LP relaxation. \nReason: " + std::string(error_text));
+		}
+
+		std::vector<double> pi(CPXgetnumrows(env, relaxation), 0.0);
+		status = CPXgetpi(env, relaxation, pi.data(), 0, static_cast<int>(pi.size()) - 1);
+		CPXfreeprob(env, &relaxation);
+		if (status != 0)
+		{
+			std::cout << "\nNo duals for the LP relaxation, the left out arcs are not priced";
+			return;
+		}
+
+		// Reduced cost of x_qvijk: 0 - sum(rows) pi_row * a_row,qvijk (rows of constraints 1, 3, 5, 6, 8 and 9;
+		// constraint 10 and rows of constraint 8 that were left out would be new rows, with dual 0)
+		size_t nb_priced = 0, nb_improving = 0;
+		double min_reduced_cost = 0;
+		for (int q = 0; q < nb_truck_types; ++q)
+		{
+			for (auto&& arc : _sparsified_arcs_q[q])
+			{
+				const double time = arc_time(data, q, arc.i, arc.j);
+				for (int v = 0; v < nb_trucks; ++v)
+				{
+					const int qv = q * nb_trucks + v;
+					double reduced_cost = pi[_startindex_c1_qv + qv] * time;
+
+					if (arc.j < nb_zones) // c3: arriving at zone j
+					{
+						for (int t = 0; t < data.nb_waste_types(); ++t)
+						{
+							if (!compatible_tq(t, q))
+								continue;
+							const int row = _startindex_c3_tqvik + ((_w_block_tq[t * nb_truck_types + q] * nb_trucks + v) * nb_zones + arc.j) * nb_segments + arc.k;
+							reduced_cost += pi[row] * data.capacity(static_cast<size_t>(q), static_cast<size_t>(t));
+						}
+					}
+					if (arc.i == index_depot && arc.k == 0)
+						reduced_cost -= pi[_startindex_c5_qv + qv];
+					if (arc.j == index_depot)
+						reduced_cost -= pi[_startindex_c6_qv + qv];
+					if (arc.i != index_depot && arc.k > 0) // c8 for (i,k-1): leaving i
+					{
+						const int row = _rowindex_c8_qvik[(qv * nb_locations + arc.i) * nb_segments + arc.k - 1];
+						if (row >= 0)
+							reduced_cost -= pi[row];
+					}
+					if (arc.j != index_depot && arc.k < nb_segments - 1) // c8 for (j,k): arriving at j
+					{
+						const int row = _rowindex_c8_qvik[(qv * nb_locations + arc.j) * nb_segments + arc.k];
+						if (row >= 0)
+							reduced_cost += pi[row];
+					}
+					reduced_cost -= pi[_startindex_c9_qvk + qv * nb_segments + arc.k];
+
+					++nb_priced;
+					if (reduced_cost < -1e-6)
+						++nb_improving;
+					min_reduced_cost = std::min(min_reduced_cost, reduced_cost);
+				}
+			}
+		}
+
+		std::cout << "\nPricing of the arcs left out by sparsification: " << nb_improving << " of " << nb_priced
+			<< " arc variables have a negative reduced cost (minimum " << min_reduced_cost << ")";
+		if (nb_improving > 0)
+			std::cout << "\nWarning: the sparse model may have missed better routes";
+	}
+
 	void IP_model_routing::clear_cplex()
 	{
 		int status = 0;
@@ -1657,12 +1370,547 @@ namespace IVM
 		}
 	}
 
+	void IP_model_routing::update_day(const Instance& data, size_t day)
+	{
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = 0;
+		auto start_time = std::chrono::system_clock::now();
+
+		const size_t nb_waste_types = data.nb_waste_types();
+		const size_t nb_truck_types = data.nb_truck_types();
+		const size_t nb_zones = data.nb_zones();
+		const size_t nb_days = data.nb_days();
+		const size_t nb_collection_points = data.nb_collection_points();
+		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
+		const size_t dayweek = day % nb_days;
+		const size_t week = day / nb_days; // integer division
+
+		// 4. sum(q,v,k) w_tqvik == alpha_tid   forall t,i
+		std::vector<int> rowind;
+		std::vector<double> rhs;
+		rowind.reserve(nb_waste_types * nb_zones);
+		rhs.reserve(nb_waste_types * nb_zones);
+		for (int t = 0; t < nb_waste_types; ++t)
+		{
+			for (int m = 0; m < nb_zones; ++m)
+			{
+				rowind.push_back(_startindex_c4_ti + t * static_cast<int>(nb_zones) + m);
+				rhs.push_back(data.x_tmdw(t, m, dayweek, week));
+			}
+		}
+
+		status = CPXchgrhs(env, problem, static_cast<int>(rowind.size()), rowind.data(), rhs.data());
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_routing::update_day(). \nCouldn't change right-hand sides. \nReason: " + std::string(error_text));
+		}
+
+		// Bounds: no pickups of waste type t in zone m => w_tqvik == 0
+		//         no pickups at all in zone m => no arcs to zone m (x_qvijm == 0)
+		// These bounds are implied by constraints 1 and 4 (visiting a zone only costs time), but help presolve
+		std::vector<int> colind;
+		std::vector<char> lu;
+		std::vector<double> bd;
+		for (int m = 0; m < nb_zones; ++m)
+		{
+			bool zone_has_pickups = false;
+			for (int t = 0; t < nb_waste_types; ++t)
+			{
+				const bool pickups = data.x_tmdw(t, m, dayweek, week) > 0;
+				zone_has_pickups = zone_has_pickups || pickups;
+
+				for (int q = 0; q < nb_truck_types; ++q)
+				{
+					if (!compatible_tq(t, q))
+						continue;
+
+					for (int v = 0; v < _max_nb_trucks; ++v)
+					{
+						for (int k = 0; k < _max_nb_segments; ++k)
+						{
+							colind.push_back(index_w_tqvik(t, q, v, m, k));
+							lu.push_back('U');
+							bd.push_back(pickups ? CPX_INFBOUND : 0);
+						}
+					}
+				}
+			}
+
+			for (int q = 0; q < nb_truck_types; ++q)
+			{
+				for (int v = 0; v < _max_nb_trucks; ++v)
+				{
+					for (int i = 0; i < nb_locations; ++i)
+					{
+						for (int k = 0; k < _max_nb_segments; ++k)
+						{
+							if (!_layout_x_qvijk.contains(q, i, m, k))
+								continue;
+							colind.push_back(index_x_qvijk(q, v, i, m, k));
+							lu.push_back('U');
+							bd.push_back(zone_has_pickups ? 1 : 0);
+						}
+					}
+				}
+			}
+		}
+
+		status = CPXchgbds(env, problem, static_cast<int>(colind.size()), colind.data(), lu.data(), bd.data());
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_routing::update_day(). \nCouldn't change bounds. \nReason: " + std::string(error_text));
+		}
+
+		std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+		std::cout << "\nModel updated for day " << day + 1 << " in " << elapsed_time.count() << " s";
+	}
+
+	double IP_model_routing::day_similarity(const Instance& data, size_t day1, size_t day2)
+	{
+		const size_t nb_days = data.nb_days();
+
+		// weighted Jaccard index: sum(t,m) min(x1,x2) / sum(t,m) max(x1,x2)
+		double overlap = 0, total = 0;
+		for (size_t t = 0; t < data.nb_waste_types(); ++t)
+		{
+			for (size_t m = 0; m < data.nb_zones(); ++m)
+			{
+				const double x1 = data.x_tmdw(t, m, day1 % nb_days, day1 / nb_days);
+				const double x2 = data.x_tmdw(t, m, day2 % nb_days, day2 / nb_days);
+				overlap += std::min(x1, x2);
+				total += std::max(x1, x2);
+			}
+		}
+
+		if (total <= 0)
+			return 0;
+		return overlap / total;
+	}
+
+	int IP_model_routing::most_similar_day(const Instance& data, size_t day, const std::vector<Day_Output>& outputs)
+	{
+		int best_day = -1;
+		double best_similarity = 0;
+		for (size_t d = 0; d < outputs.size(); ++d)
+		{
+			if (d == day || !outputs[d].solved || outputs[d].solution_indices.empty())
+				continue;
+
+			// ties: the closest day
+			const double similarity = day_similarity(data, day, d);
+			if (similarity > best_similarity || (similarity == best_similarity && best_day >= 0
+				&& std::abs(static_cast<int>(d) - static_cast<int>(day)) < std::abs(best_day - static_cast<int>(day))))
+			{
+				best_similarity = similarity;
+				best_day = static_cast<int>(d);
+			}
+		}
+		return best_day;
+	}
+
+	bool IP_model_routing::add_mip_start(const Instance& data, size_t day, size_t source_day, const Day_Output& source)
+	{
+		char error_text[CPXMESSAGEBUFSIZE];
+		int status = 0;
+
+		const size_t nb_waste_types = data.nb_waste_types();
+		const size_t nb_truck_types = data.nb_truck_types();
+		const size_t nb_zones = data.nb_zones();
+		const size_t nb_days = data.nb_days();
+		const size_t nb_collection_points = data.nb_collection_points();
+		const size_t nb_locations = nb_zones + 1 + nb_collection_points; // Order: Z1...Zn, depot, CP1...CPk
+
+		// Zones where the pickups are different on both days
+		std::vector<bool> zone_differs(nb_zones, false);
+		for (int m = 0; m < nb_zones; ++m)
+		{
+			for (int t = 0; t < nb_waste_types; ++t)
+			{
+				if (data.x_tmdw(t, m, day % nb_days, day / nb_days) != data.x_tmdw(t, m, source_day % nb_days, source_day / nb_days))
+					zone_differs[m] = true;
+			}
+		}
+
+		// Solution of the other day (same model structure, so the same column indices)
+		std::vector<double> values(CPXgetnumcols(env, problem), 0.0);
+		for (size_t n = 0; n < source.solution_indices.size(); ++n)
+			values[source.solution_indices[n]] = source.solution_values[n];
+
+		// Repair: keep the used trucks that only visit zones with the same pickups (all their variables are fixed),
+		//         the trucks that visit a zone with different pickups and the unused trucks are left to CPLEX
+		std::vector<int> indices;
+		std::vector<double> start_values;
+		size_t nb_trucks_kept = 0, nb_trucks_dropped = 0;
+		for (int q = 0; q < nb_truck_types; ++q)
+		{
+			for (int v = 0; v < _max_nb_trucks; ++v)
+			{
+				if (values[index_y_qv(q, v)] < 0.5)
+					continue;
+
+				bool keep = true;
+				for (int j = 0; j < nb_zones && keep; ++j)
+				{
+					if (!zone_differs[j])
+						continue;
+					for (int i = 0; i < nb_locations && keep; ++i)
+						for (int k = 0; k < _max_nb_segments && keep; ++k)
+							keep = !_layout_x_qvijk.contains(q, i, j, k) || values[index_x_qvijk(q, v, i, j, k)] < 0.5;
+				}
+				if (!keep)
+				{
+					++nb_trucks_dropped;
+					continue;
+				}
+				++nb_trucks_kept;
+
+				for (size_t index : _layout_x_qvijk.slice(q, v))
+				{
+					indices.push_back(static_cast<int>(index));
+					start_values.push_back(values[index]);
+				}
+				for (int t = 0; t < nb_waste_types; ++t)
+				{
+					if (!compatible_tq(t, q))
+						continue;
+
+					const int begin_w = index_w_tqvik(t, q, v, 0, 0);
+					const int end_w = begin_w + static_cast<int>(nb_zones * _max_nb_segments);
+					for (int index = begin_w; index < end_w; ++index)
+					{
+						indices.push_back(index);
+						start_values.push_back(values[index]);
+					}
+				}
+				indices.push_back(index_y_qv(q, v));
+				start_values.push_back(1.0);
+				indices.push_back(index_beta_qv(q, v));
+				start_values.push_back(values[index_beta_qv(q, v)]);
+			}
+		}
+
+		if (nb_trucks_kept == 0)
+			return false;
+
+		// Remove the MIP starts of earlier days (reused model)
+		const int nb_mipstarts = CPXgetnummipstarts(env, problem);
+		if (nb_mipstarts > 0)
+		{
+			status = CPXdelmipstarts(env, problem, 0, nb_mipstarts - 1);
+			if (status != 0)
+			{
+				CPXgeterrorstring(env, status, error_text);
+				throw std::runtime_error("Error in function IP_model_routing::add_mip_start(). \nCouldn't delete MIP starts. \nReason: " + std::string(error_text));
+			}
+		}
+
+		const int beg = 0;
+		const int effortlevel = CPX_MIPSTART_REPAIR;
+		status = CPXaddmipstarts(env, problem, 1, static_cast<int>(indices.size()), &beg, indices.data(), start_values.data(), &effortlevel, NULL);
+		if (status != 0)
+		{
+			CPXgeterrorstring(env, status, error_text);
+			throw std::runtime_error("Error in function IP_model_routing::add_mip_start(). \nCouldn't add MIP start. \nReason: " + std::string(error_text));
+		}
+
+		std::cout << "\nMIP start for day " << day + 1 << " from day " << source_day + 1 << " (similarity " << day_similarity(data, day, source_day)
+			<< ", " << nb_trucks_kept << " trucks kept, " << nb_trucks_dropped << " trucks repaired by CPLEX)";
+		return true;
+	}
+
+	int CPXPUBLIC IP_model_routing::incumbent_callback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle)
+	{
+		auto log = static_cast<Incumbent_Log*>(cbhandle);
+		if (log->time_first_incumbent < 0)
+		{
+			int feasible = 0;
+			if (CPXgetcallbackinfo(env, cbdata, wherefrom, CPX_CALLBACK_INFO_MIP_FEAS, &feasible) == 0 && feasible)
+			{
+				std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - log->start_time;
+				log->time_first_incumbent = elapsed_time.count();
+			}
+		}
+		return 0;
+	}
+
+	void IP_model_routing::solve_day(const Instance& data, size_t day, int start_day, const Day_Output* start)
+	{
+		if (!_reuse_model || problem == nullptr)
+		{
+			initialize_cplex();
+			build_problem(data, day);
+		}
+		if (_reuse_model)
+			update_day(data, day);
+
+		const bool mip_start = (start != nullptr && start_day >= 0 && add_mip_start(data, day, start_day, *start));
+
+		solve_problem(data, day);
+		if (mip_start)
+			_day_output.start_day = start_day;
+		if (_arc_reprice)
+			price_sparsified_arcs(data);
+
+		if (!_reuse_model)
+			clear_cplex();
+	}
+
+	void IP_model_routing::write_day_output(const Instance& data, size_t day, const Day_Output& output) const
+	{
+		const std::pair<std::string, const std::string*> files[] = {
+			{ "_routing.txt", &output.routing },
+			{ "_routing_alt.txt", &output.routing_alt },
+			{ "_routing_altshort.txt", &output.routing_altshort },
+			{ "_trucks.txt", &output.trucks },
+			{ "_routes.xml", &output.routes_xml }
+		};
+
+		for (auto&& file : files)
+		{
+			if (file.second->empty())
+				continue;
+
+			try
+			{
+				std::ofstream outfile;
+				std::string filename = data.name_instance() + file.first;
+				if (day == 0)
+					outfile.open(filename);
+				else
+					outfile.open(filename, std::ios_base::app); // append
+
+				outfile << *file.second;
+				outfile.flush();
+			}
+			catch (const std::exception& e)
+			{
+				std::cout << "\n\n\nError in function IP_model_routing::write_day_output()."
+					<< "\nProblem with writing solution representation to file " << file.first << ".\n"
+					<< e.what()
+					<< "\n\n\n";
+			}
+		}
+	}
+
 	void IP_model_routing::run(const Instance& data, size_t day)
 	{
 		initialize_cplex();
 		build_problem(data, day);
 		solve_problem(data, day);
+		if (_arc_reprice)
+			price_sparsified_arcs(data);
 		clear_cplex();
+
+		write_day_output(data, day, _day_output);
+	}
+
+	void IP_model_routing::run_all_days(const Instance& data, size_t nb_parallel_days)
+	{
+		const size_t nb_days_total = data.nb_weeks() * data.nb_days();
+		double total_objective_value = 0;
+
+		// Solve the days one after the other
+		if (nb_parallel_days <= 1)
+		{
+			std::vector<Day_Output> outputs(nb_days_total);
+			for (size_t d = 0; d < nb_days_total; ++d)
+			{
+				const int start_day = _cross_day_starts ? most_similar_day(data, d, outputs) : -1;
+				solve_day(data, d, start_day, start_day >= 0 ? &outputs[start_day] : nullptr);
+				write_day_output(data, d, _day_output);
+				if (_day_output.solved)
+					total_objective_value += _day_output.objective_value;
+
+				outputs[d] = std::move(_day_output);
+				outputs[d].routing.clear(); // already written, only the solution is needed
+				outputs[d].routing_alt.clear();
+				outputs[d].routing_altshort.clear();
+				outputs[d].trucks.clear();
+				outputs[d].routes_xml.clear();
+			}
+			if (problem != nullptr) // reused model
+				clear_cplex();
+
+			print_day_statistics(outputs);
+			_objective_value = total_objective_value;
+			return;
+		}
+
+		// Solve several days at the same time, each in its own CPLEX environment
+		// The cores are divided over the days, so that CPLEX never uses more threads than there are cores
+		size_t nb_cores = std::thread::hardware_concurrency();
+		if (nb_cores == 0)
+			nb_cores = nb_parallel_days;
+		const size_t nb_workers = std::min(std::min(nb_parallel_days, nb_days_total), nb_cores);
+		const int nb_threads_per_day = static_cast<int>(std::max<size_t>(1, nb_cores / nb_workers));
+
+		std::cout << "\n\nSolving " << nb_days_total << " days with " << nb_workers << " days in parallel ("
+			<< nb_threads_per_day << " threads per day)";
+
+		std::vector<Day_Output> outputs(nb_days_total);
+		std::mutex outputs_mutex; // MIP starts read the outputs of the other workers
+		std::vector<std::exception_ptr> errors(nb_workers);
+		std::vector<size_t> failed_days(nb_workers, nb_days_total);
+		std::atomic<size_t> next_day(0);
+
+		std::vector<std::thread> workers;
+		for (size_t w = 0; w < nb_workers; ++w)
+		{
+			workers.emplace_back([this, &data, &outputs, &outputs_mutex, &errors, &failed_days, &next_day, nb_days_total, nb_threads_per_day, w]()
+				{
+					size_t d = nb_days_total; // the day being solved
+					try
+					{
+						IP_model_routing model(*this); // same settings, own CPLEX environment
+						model._nb_threads = nb_threads_per_day;
+
+						try
+						{
+							for (d = next_day++; d < nb_days_total; d = next_day++)
+							{
+								// only the days that are finished at this moment can be used as MIP start
+								int start_day = -1;
+								Day_Output start;
+								if (_cross_day_starts)
+								{
+									std::lock_guard<std::mutex> lock(outputs_mutex);
+									start_day = most_similar_day(data, d, outputs);
+									if (start_day >= 0)
+									{
+										start.solution_indices = outputs[start_day].solution_indices;
+										start.solution_values = outputs[start_day].solution_values;
+									}
+								}
+
+								model.solve_day(data, d, start_day, start_day >= 0 ? &start : nullptr);
+
+								std::lock_guard<std::mutex> lock(outputs_mutex);
+								outputs[d] = std::move(model._day_output);
+							}
+						}
+						catch (...)
+						{
+							// free the CPLEX objects of the failed day (errors while freeing are ignored, the first error is reported)
+							if (model.problem != nullptr)
+								CPXfreeprob(model.env, &model.problem);
+							if (model.env != nullptr)
+								CPXcloseCPLEX(&model.env);
+							throw;
+						}
+						if (model.problem != nullptr) // reused model
+							model.clear_cplex();
+					}
+					catch (...)
+					{
+						errors[w] = std::current_exception();
+						failed_days[w] = d;
+						next_day = nb_days_total; // other workers stop after their current day
+					}
+				});
+		}
+		for (auto&& worker : workers)
+			worker.join();
+
+		for (size_t w = 0; w < nb_workers; ++w)
+		{
+			if (errors[w])
+			{
+				// Keep the days the other workers finished (in day order, the days that were not solved have no output)
+				for (size_t d = 0; d < nb_days_total; ++d)
+					write_day_output(data, d, outputs[d]);
+				print_day_statistics(outputs);
+				if (failed_days[w] < nb_days_total)
+					std::cout << "\n\nError while solving day " << failed_days[w] + 1;
+				std::rethrow_exception(errors[w]);
+			}
+		}
+
+		// Output in the same order as when the days are solved one after the other
+		for (size_t d = 0; d < nb_days_total; ++d)
+		{
+			write_day_output(data, d, outputs[d]);
+			if (outputs[d].solved)
+				total_objective_value += outputs[d].objective_value;
+		}
+		print_day_statistics(outputs);
+		_objective_value = total_objective_value;
+	}
+
+	void IP_model_routing::print_day_statistics(const std::vector<Day_Output>& outputs) const
+	{
+		std::cout << "\n\nDay\tMIP start from day\tTime to first incumbent (s)\tFinal gap\tObjective value";
+		for (size_t d = 0; d < outputs.size(); ++d)
+		{
+			std::cout << "\n" << d + 1 << "\t";
+			if (outputs[d].start_day >= 0)
+				std::cout << outputs[d].start_day + 1;
+			else
+				std::cout << "-";
+			if (outputs[d].solved)
+				std::cout << "\t" << outputs[d].time_first_incumbent << "\t" << outputs[d].gap << "\t" << outputs[d].objective_value;
+			else
+				std::cout << "\tno solution";
+		}
+	}
+
+	void IP_model_routing::benchmark_build(const Instance& data, size_t day)
+	{
+		std::cout << "\n\nBenchmark building the routing problem for day " << day + 1;
+
+		// reference: one call to CPLEX per variable and constraint, then in bulk
+		double build_time[2];
+		for (int batched = 0; batched < 2; ++batched)
+		{
+			_batched_build = (batched == 1);
+
+			initialize_cplex();
+			auto start_time = std::chrono::system_clock::now();
+			build_problem(data, day);
+			std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+			build_time[batched] = elapsed_time.count();
+			clear_cplex();
+		}
+		_batched_build = true;
+
+		std::cout << "\n\nBuild time one call per variable/constraint (s): " << build_time[0];
+		std::cout << "\nBuild time in bulk (s): " << build_time[1];
+		std::cout << "\nSpeedup: " << build_time[0] / build_time[1];
+	}
+
+	void IP_model_routing::benchmark_symmetry_breaking(const Instance& data, size_t day)
+	{
+		std::cout << "\n\nBenchmark symmetry breaking for the routing problem of day " << day + 1;
+
+		const int symmetry_breaking = _symmetry_breaking;
+		std::ostringstream table;
+		table << "\n\nSymmetry breaking\tStatus\tObjective value\tGap\tNodes\tTime (s)";
+		for (int level = SYMMETRY_NONE; level <= SYMMETRY_ORDER_AND_CPLEX; ++level)
+		{
+			_symmetry_breaking = level;
+
+			initialize_cplex();
+			build_problem(data, day);
+			auto start_time = std::chrono::system_clock::now();
+			solve_problem(data, day);
+			std::chrono::duration<double, std::ratio<1, 1>> elapsed_time = std::chrono::system_clock::now() - start_time;
+
+			char solstat_text[CPXMESSAGEBUFSIZE];
+			if (CPXgetstatstring(env, CPXgetstat(env, problem), solstat_text) == nullptr)
+				std::strcpy(solstat_text, "unknown");
+			table << "\n" << level << "\t" << solstat_text << "\t";
+			if (_day_output.solved)
+				table << _day_output.objective_value << "\t" << _day_output.gap;
+			else
+				table << "-\t-";
+			table << "\t" << CPXgetnodecnt(env, problem) << "\t" << elapsed_time.count();
+
+			clear_cplex();
+		}
+		_symmetry_breaking = symmetry_breaking;
+
+		std::cout << table.str();
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -12,9 +12,38 @@
 #include <stdexcept>
 #include <chrono>
 #include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <bitset>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace IVM
 {
+	namespace
+	{
+		/*!
+		 *	@brief Get the index of the lowest set bit of a word (the word should not be 0)
+		 */
+		inline size_t lowest_set_bit(uint64_t word)
+		{
+#if defined(_MSC_VER) && defined(_WIN64)
+			unsigned long index;
+			_BitScanForward64(&index, word);
+			return index;
+#elif defined(_MSC_VER) // Win32: no 64-bit intrinsic, scan the two halves
+			unsigned long index;
+			if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+				return index;
+			_BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+			return 32 + index;
+#else
+			return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+		}
+	}
+
 	///////////////////////////////////////////
 	///			  Problem data  			///
 	///////////////////////////////////////////
@@ -59,6 +88,23 @@ namespace IVM
 		_max_visits = std::stoull(text);
 
 
+		// Names are interned in the order in which they are defined (Afvaltype, Collectiepunt, Zone) and must be defined before they are used,
+		// except for the driving times between zones, which are resolved at the end
+		auto intern = [](std::unordered_map<std::string, size_t>& ids, const std::string& name, const std::string& what)
+		{
+			const size_t id = ids.size();
+			if (!ids.emplace(name, id).second)
+				throw std::runtime_error("Error in function Instance::read_data(). " + what + " \"" + name + "\" is defined more than once");
+			return id;
+		};
+		auto set_by_id = [](std::vector<double>& values, size_t id, double value)
+		{
+			if (values.size() <= id)
+				values.resize(id + 1, 0);
+			values[id] = value;
+		};
+		std::vector<std::pair<size_t, std::pair<std::string, double>>> driving_times_zones;
+
 		// Child nodes
 		tinyxml2::XMLElement* child;
 		for (child = rootnode->FirstChildElement(); child; child = child->NextSiblingElement())
@@ -78,8 +124,9 @@ namespace IVM
 				text = child->Attribute("lostijd");
 				lostijd = std::stod(text);
 
+				intern(_waste_type_ids, waste_type, "Afvaltype");
 				_waste_types.push_back(waste_type);
-				_waste_type_unloading_time[waste_type] = lostijd;
+				_time_unloading_t.push_back(lostijd);
 			}
 			else if (text == "Trucktype")
 			{
@@ -122,7 +169,7 @@ namespace IVM
 						text = truckchild->Attribute("cap");
 						cap = std::stod(text);
 
-						_trucks.back()._capacities[afvaltype] = cap;
+						set_by_id(_trucks.back()._capacities, waste_type_index(afvaltype), cap);
 					}
 				}
 			}
@@ -135,6 +182,7 @@ namespace IVM
 				if (child->Attribute("naam") == nullptr)
 					throw std::runtime_error("Error in function Instance::read_data(). Collectiepunt does not contain an attribute \"naam\"");
 				naamc = child->Attribute("naam");
+				intern(_collection_point_ids, naamc, "Collectiepunt");
 				_collection_points.back()._name = naamc;
 
 				tinyxml2::XMLElement* collchild;
@@ -149,7 +197,7 @@ namespace IVM
 							throw std::runtime_error("Error in function Instance::read_data(). ToegelatenAfval does not contain an attribute \"naam\"");
 						afvaltype = collchild->Attribute("naam");
 
-						_collection_points.back()._allowed_waste_types.push_back(afvaltype);
+						_collection_points.back()._allowed_waste_types.push_back(waste_type_index(afvaltype));
 					}
 					else if (text == "Rijtijd")
 					{
@@ -176,6 +224,8 @@ namespace IVM
 				if (child->Attribute("naam") == nullptr)
 					throw std::runtime_error("Error in function Instance::read_data(). Zone does not contain an attribute \"naam\"");
 				_zones.back()._name = child->Attribute("naam");
+				const size_t zone_id = intern(_zone_ids, _zones.back()._name, "Zone");
+				_zones.back()._driving_time_collection_points.assign(_collection_points.size(), -1);
 
 				tinyxml2::XMLElement* zonechild;
 				for (zonechild = child->FirstChildElement(); zonechild; zonechild = zonechild->NextSiblingElement())
@@ -201,8 +251,9 @@ namespace IVM
 						text = zonechild->Attribute("collectietijd");
 						collectietijd = std::stod(text);
 
-						_zones.back()._demands[afvaltype] = hoeveelheid;
-						_zones.back()._collection_times[afvaltype] = collectietijd;
+						const size_t waste_type_id = waste_type_index(afvaltype);
+						set_by_id(_zones.back()._demands, waste_type_id, hoeveelheid);
+						set_by_id(_zones.back()._collection_times, waste_type_id, collectietijd);
 					}
 					else if (text == "HuidigeKalender")
 					{
@@ -224,8 +275,9 @@ namespace IVM
 						text = zonechild->Attribute("week");
 						week = std::stoi(text) - 1; // index starts at 1 in xml, but at 0 in code
 
-						_zones.back()._current_calendar_day.insert(std::pair<std::string, int>(afvaltype, dagindex));
-						_zones.back()._current_calendar_week.insert(std::pair<std::string, int>(afvaltype, week));
+						const size_t waste_type_id = waste_type_index(afvaltype);
+						_zones.back()._current_calendar_day.insert(std::pair<size_t, int>(waste_type_id, dagindex));
+						_zones.back()._current_calendar_week.insert(std::pair<size_t, int>(waste_type_id, week));
 					}
 					else if (text == "Rijtijd")
 					{
@@ -241,7 +293,13 @@ namespace IVM
 						text = zonechild->Attribute("tijd");
 						time = std::stod(text);
 
-						_zones.back()._driving_time[destination] = time;
+						auto it_cp = _collection_point_ids.find(destination);
+						if (destination == "Depot")
+							_zones.back()._driving_time_depot = time;
+						else if (it_cp != _collection_point_ids.end())
+							_zones.back()._driving_time_collection_points[it_cp->second] = time;
+						else // another zone (possibly defined later, resolved at the end)
+							driving_times_zones.push_back({ zone_id, { destination, time } });
 					}
 					else if (text == "VerbodenDag")
 					{
@@ -253,7 +311,166 @@ namespace IVM
 						dag = zonechild->Attribute("dag");
 						dagindex = _dag_naam_index.at(dag);
 
-						_zones.back()._forbidden_days.push_back(dagindex);
+						_zones.back()._forbidden_days |= (uint32_t(1) << dagindex);
+					}
+				}
+			}
+		}
+
+		for (auto&& zone_time : driving_times_zones)
+		{
+			auto it = _zone_ids.find(zone_time.second.first);
+			if (it != _zone_ids.end()) // other destinations are not used
+				_zones[zone_time.first]._driving_time_zones.push_back({ it->second, zone_time.second.second });
+		}
+
+		compute_dense_matrices();
+		compute_collection_point_dominance();
+	}
+
+	size_t Instance::symbol_id(const std::unordered_map<std::string, size_t>& ids, const std::string& name, const std::string& what)
+	{
+		auto it = ids.find(name);
+		if (it == ids.end())
+			throw std::runtime_error("Error in function Instance::symbol_id(). Unknown " + what + " \"" + name + "\"");
+		return it->second;
+	}
+
+	void Instance::compute_dense_matrices()
+	{
+		const size_t nb_types = _waste_types.size();
+		const size_t nb_locations = this->nb_locations();
+		const size_t index_depot = _zones.size();
+
+		// driving times (the zones store the times to the depot and the collection points, which are used in both directions)
+		_time_driving_ll.assign(nb_locations * nb_locations, -1);
+		for (size_t l = 0; l < nb_locations; ++l)
+			_time_driving_ll[l * nb_locations + l] = 0;
+
+		auto set_time = [&](size_t from, size_t to, double time)
+		{
+			_time_driving_ll[from * nb_locations + to] = time;
+			_time_driving_ll[to * nb_locations + from] = time;
+		};
+
+		for (size_t i = 0; i < _zones.size(); ++i)
+		{
+			if (_zones[i]._driving_time_depot < 0)
+				throw std::runtime_error("Error in function Instance::read_data(). Zone \"" + _zones[i]._name + "\" has no Rijtijd to \"Depot\"");
+			set_time(i, index_depot, _zones[i]._driving_time_depot);
+
+			for (size_t c = 0; c < _collection_points.size(); ++c)
+			{
+				const auto& times = _zones[i]._driving_time_collection_points;
+				const double time = (c < times.size()) ? times[c] : -1; // collection points must be defined before the zones
+				if (time < 0)
+					throw std::runtime_error("Error in function Instance::read_data(). Zone \"" + _zones[i]._name + "\" has no Rijtijd to \"" + _collection_points[c]._name + "\"");
+				set_time(i, index_depot + 1 + c, time);
+			}
+
+			for (auto&& zone_time : _zones[i]._driving_time_zones) // optional, not used in the models
+			{
+				if (zone_time.first != i)
+					_time_driving_ll[i * nb_locations + zone_time.first] = zone_time.second;
+			}
+		}
+
+		for (size_t c = 0; c < _collection_points.size(); ++c)
+			set_time(index_depot + 1 + c, index_depot, _collection_points[c]._driving_time_depot);
+
+		// zones and waste types
+		_demand_it.assign(_zones.size() * nb_types, 0);
+		_time_pickup_it.assign(_zones.size() * nb_types, 0);
+		for (size_t i = 0; i < _zones.size(); ++i)
+		{
+			std::copy(_zones[i]._demands.begin(), _zones[i]._demands.end(), _demand_it.begin() + i * nb_types);
+			std::copy(_zones[i]._collection_times.begin(), _zones[i]._collection_times.end(), _time_pickup_it.begin() + i * nb_types);
+		}
+
+		// trucks and waste types
+		_capacity_qt.assign(_trucks.size() * nb_types, 0);
+		for (size_t q = 0; q < _trucks.size(); ++q)
+			std::copy(_trucks[q]._capacities.begin(), _trucks[q]._capacities.end(), _capacity_qt.begin() + q * nb_types);
+
+		// collection points and waste types
+		_waste_type_allowed_ct.assign(_collection_points.size() * nb_types, false);
+		for (size_t c = 0; c < _collection_points.size(); ++c)
+		{
+			for (size_t t : _collection_points[c]._allowed_waste_types)
+				_waste_type_allowed_ct[c * nb_types + t] = true;
+		}
+
+		// current calendar (as before, a pickup day and a pickup week of the zone are combined into every pair)
+		_calendar_words = (_nb_days * _nb_weeks + 63) / 64;
+		_current_calendar_tm.assign(nb_types * _zones.size() * _calendar_words, 0);
+		for (size_t i = 0; i < _zones.size(); ++i)
+		{
+			for (auto&& day : _zones[i]._current_calendar_day)
+			{
+				auto range_week = _zones[i]._current_calendar_week.equal_range(day.first);
+				for (auto it = range_week.first; it != range_week.second; ++it)
+				{
+					if (day.second < 0 || day.second >= static_cast<int>(_nb_days) || it->second < 0 || it->second >= static_cast<int>(_nb_weeks))
+						continue; // outside the planning horizon
+
+					const size_t bit = day.second * _nb_weeks + it->second;
+					_current_calendar_tm[(day.first * _zones.size() + i) * _calendar_words + bit / 64] |= (uint64_t(1) << (bit % 64));
+				}
+			}
+		}
+	}
+
+	void Instance::compute_collection_point_dominance()
+	{
+		const size_t nb_cps = _collection_points.size();
+		const size_t nb_types = _waste_types.size();
+		_collection_point_dominated.assign(_zones.size() * nb_types * nb_cps, false);
+
+		// A dominates B for zone i: tau(i,A) + tau(A,j) <= tau(i,B) + tau(B,j) for every next stop j (zones and depot)
+		auto dominates = [&](size_t a, size_t b, size_t i)
+		{
+			const double time_ia = time_driving_zone_collectionpoint(i, a), time_ib = time_driving_zone_collectionpoint(i, b);
+
+			bool strict = false;
+			for (size_t j = 0; j < _zones.size(); ++j)
+			{
+				const double time_ja = time_driving_zone_collectionpoint(j, a), time_jb = time_driving_zone_collectionpoint(j, b);
+				if (time_ia + time_ja > time_ib + time_jb + 1e-9)
+					return false;
+				strict = strict || time_ia + time_ja < time_ib + time_jb - 1e-9;
+			}
+
+			const double time_depot_a = time_ia + time_driving_collectionpoint_depot(a);
+			const double time_depot_b = time_ib + time_driving_collectionpoint_depot(b);
+			if (time_depot_a > time_depot_b + 1e-9)
+				return false;
+			strict = strict || time_depot_a < time_depot_b - 1e-9;
+
+			return strict || a < b; // equivalent collection points: keep the one with the lowest index
+		};
+
+		for (size_t b = 0; b < nb_cps; ++b)
+		{
+			for (size_t a = 0; a < nb_cps; ++a)
+			{
+				if (a == b || _collection_points[a]._allowed_waste_types.size() != _collection_points[b]._allowed_waste_types.size())
+					continue;
+
+				bool same_waste_types = true;
+				for (size_t waste_type : _collection_points[b]._allowed_waste_types)
+					same_waste_types = same_waste_types && collection_point_waste_type_allowed(a, waste_type);
+				if (!same_waste_types)
+					continue;
+
+				for (size_t i = 0; i < _zones.size(); ++i)
+				{
+					if (!dominates(a, b, i))
+						continue;
+
+					for (size_t t = 0; t < nb_types; ++t)
+					{
+						if (collection_point_waste_type_allowed(b, t))
+							_collection_point_dominated[(i * nb_types + t) * nb_cps + b] = true;
 					}
 				}
 			}
@@ -335,22 +552,11 @@ namespace IVM
 
 
 			// zet om naar indices
-			int waste_type_index, zone_index;
-			for (int t = 0; t < nb_waste_types(); ++t) {
-				if (waste_type(t) == afvaltype) {
-					waste_type_index = t;
-					break;
-				}
-			}
-			for (int m = 0; m < nb_zones(); ++m) {
-				if (zone_name(m) == zone) {
-					zone_index = m;
-					break;
-				}
-			}
+			const size_t waste_type_id = waste_type_index(afvaltype);
+			const size_t zone_id = zone_index(zone);
 
 			// sla op in vector
-			_sol_alloc_x_tmdw[waste_type_index * nb_zones() * nb_days() * nb_weeks() + zone_index * nb_days() * nb_weeks() + day * nb_weeks() + week] = hoeveelheid;
+			_sol_alloc_x_tmdw[waste_type_id * nb_zones() * nb_days() * nb_weeks() + zone_id * nb_days() * nb_weeks() + day * nb_weeks() + week] = hoeveelheid;
 		}
 	}
 
@@ -395,7 +601,7 @@ namespace IVM
 			if (child->Attribute("afval_type") == nullptr)
 				throw std::runtime_error("Error in function Instance::read_routes_xml(). Route does not contain an attribute \"afval_type\"");
 			std::string afvaltype = child->Attribute("afval_type");
-			_routes.back()._waste_type = afvaltype;
+			_routes.back()._waste_type = waste_type_index(afvaltype);
 
 			if (child->Attribute("dag") == nullptr)
 				throw std::runtime_error("Error in function Instance::read_routes_xml(). Route does not contain an attribute \"dag\"");
@@ -426,7 +632,26 @@ namespace IVM
 				if (pickup->Attribute("zone") == nullptr)
 					throw std::runtime_error("Error in function Instance::read_routes_xml(). Ophaling does not contain an attribute \"zone\"");
 				std::string zone = pickup->Attribute("zone");
-				_routes.back()._pickups.push_back(zone);
+				_routes.back()._pickups.push_back(zone_index(zone));
+			}
+		}
+
+		compute_route_zone_incidence();
+	}
+
+	void Instance::compute_route_zone_incidence()
+	{
+		_route_zone_words = (_zones.size() + 63) / 64;
+		_zone_route_words = (_routes.size() + 63) / 64;
+		_route_zone_rm.assign(_routes.size() * _route_zone_words, 0);
+		_zone_route_mr.assign(_zones.size() * _zone_route_words, 0);
+
+		for (size_t r = 0; r < _routes.size(); ++r)
+		{
+			for (size_t m : _routes[r]._pickups)
+			{
+				_route_zone_rm[r * _route_zone_words + m / 64] |= (uint64_t(1) << (m % 64));
+				_zone_route_mr[m * _zone_route_words + r / 64] |= (uint64_t(1) << (r % 64));
 			}
 		}
 	}
@@ -434,86 +659,90 @@ namespace IVM
 	void Instance::clear_data()
 	{
 		_waste_types.clear();
-		_waste_type_unloading_time.clear();
+		_waste_type_ids.clear();
+		_zone_ids.clear();
+		_collection_point_ids.clear();
 		_collection_points.clear();
 		_trucks.clear();
 		_zones.clear();
+		_collection_point_dominated.clear();
+		_time_driving_ll.clear();
+		_demand_it.clear();
+		_time_pickup_it.clear();
+		_capacity_qt.clear();
+		_time_unloading_t.clear();
+		_waste_type_allowed_ct.clear();
+		_current_calendar_tm.clear();
+		_calendar_words = 0;
 
 		_sol_alloc_x_tmdw.clear();
 		_routes.clear();
+		_route_zone_rm.clear();
+		_route_zone_words = 0;
+		_zone_route_mr.clear();
+		_zone_route_words = 0;
 	}
 
-	bool Instance::current_calendar(size_t zone, const std::string& waste_type, size_t day, size_t week) const
+	size_t Instance::nb_pickups_current_calendar() const
 	{
-		bool dayfound = false;
-		auto range_day = _zones[zone]._current_calendar_day.equal_range(waste_type);
-		for (auto&& it = range_day.first; it != range_day.second; ++it) {
-			if (it->second == day) {
-				dayfound = true;
-				break;
-			}
-		}
+		size_t result = 0;
 
-		bool weekfound = false;
-		auto range_week = _zones[zone]._current_calendar_week.equal_range(waste_type);
-		for (auto&& it = range_week.first; it != range_week.second; ++it) {
-			if (it->second == week) {
-				weekfound = true;
-				break;
-			}
-		}
+		for (uint64_t word : _current_calendar_tm)
+			result += std::bitset<64>(word).count();
 
-		return (dayfound && weekfound);
+		return result;
 	}
 
-	bool Instance::zone_forbidden_day(size_t zone, size_t day) const 
-	{ 
-		for (auto&& dd : _zones[zone]._forbidden_days)
-			if (dd == day)
-				return true;
-	
-		return false;
+	std::vector<size_t> Instance::collection_points_by_driving_time(size_t zone) const
+	{
+		std::vector<size_t> collection_points(_collection_points.size());
+		for (size_t c = 0; c < collection_points.size(); ++c)
+			collection_points[c] = c;
+
+		std::stable_sort(collection_points.begin(), collection_points.end(), [&](size_t a, size_t b) {
+			return time_driving_zone_collectionpoint(zone, a) < time_driving_zone_collectionpoint(zone, b);
+			});
+		return collection_points;
 	}
 
-	size_t Instance::nb_pickups_current_calendar() const
+	double Instance::time_driving_zone_depot_percentile(double percentile) const
 	{
-		int result = 0;
-
-		for (int t = 0; t < _waste_types.size(); ++t)
-		{
-			for (int m = 0; m < _zones.size(); ++m)
-			{
-				for (int d = 0; d < _nb_days; ++d)
-				{
-					for (int w = 0; w < _nb_weeks; ++w)
-					{
-						const std::string& waste_type = _waste_types[t];
-						if (current_calendar(m, waste_type, d, w))
-							++result;
-					}
-				}
-			}
-		}
-
-		return result;
+		if (_zones.empty())
+			return 0;
+
+		std::vector<double> times(_zones.size());
+		for (size_t i = 0; i < _zones.size(); ++i)
+			times[i] = time_driving_zone_depot(i);
+		std::sort(times.begin(), times.end());
+
+		// at least one zone
+		const double position = std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100.0 * times.size());
+		const size_t index = std::max<size_t>(static_cast<size_t>(position), 1) - 1;
+		return times[index];
 	}
 
-	bool Instance::collection_point_waste_type_allowed(size_t index, const std::string& waste_type) const
+	std::vector<uint64_t> Instance::zones_visited_by_routes(const std::vector<size_t>& routes) const
 	{
-		auto& vec = _collection_points[index]._allowed_waste_types;
-		if (std::find(vec.begin(), vec.end(), waste_type) != vec.end())
-			return true;
-		return false;
+		std::vector<uint64_t> zones(_route_zone_words, 0);
+		for (size_t r : routes)
+		{
+			const uint64_t* row = _route_zone_rm.data() + r * _route_zone_words;
+			for (size_t k = 0; k < _route_zone_words; ++k) // OR of whole words (vectorizable)
+				zones[k] |= row[k];
+		}
+		return zones;
 	}
 
-	bool Instance::route_visits_zone(size_t index_route, size_t index_zone) const
+	std::vector<size_t> Instance::routes_visiting_zone(size_t index_zone) const
 	{
-		for (auto&& v : _routes[index_route]._pickups)
+		std::vector<size_t> routes;
+		const uint64_t* row = _zone_route_mr.data() + index_zone * _zone_route_words;
+		for (size_t k = 0; k < _zone_route_words; ++k)
 		{
-			if (v == _zones[index_zone]._name)
-				return true;
+			for (uint64_t word = row[k]; word != 0; word &= word - 1) // one iteration per set bit
+				routes.push_back(k * 64 + lowest_set_bit(word));
 		}
-		return false;
+		return routes;
 	}
 
 	double Instance::x_tmdw(size_t waste_type, size_t zone, size_t day, size_t week) const
@@ -24,6 +24,7 @@
 #include <vector>
 #include <unordered_map>
 #include <exception>
+#include <cstdint>
 
 namespace IVM
 {
@@ -67,6 +68,23 @@ namespace IVM
 		 */
 		std::vector<std::string> _waste_types;
 
+		/*!
+		 *	@brief	Symbol tables: the index (ID) of every waste type, zone and collection point by name.
+		 *			Names are interned when the data are read; everywhere else only the IDs are stored.
+		 */
+		std::unordered_map<std::string, size_t> _waste_type_ids;
+		std::unordered_map<std::string, size_t> _zone_ids;
+		std::unordered_map<std::string, size_t> _collection_point_ids;
+
+		/*!
+		 *	@brief	Look up a name in a symbol table
+		 *  @param	ids			The symbol table
+		 *  @param	name		The name
+		 *  @param	what		What is looked up (for the error message)
+		 *  @returns	The ID
+		 */
+		static size_t symbol_id(const std::unordered_map<std::string, size_t>& ids, const std::string& name, const std::string& what);
+
 		/*!
 		 *	@brief To store information on the different collection points
 		 */
@@ -78,9 +96,9 @@ namespace IVM
 			std::string _name;
 
 			/*!
-			 *	@brief Allowed waste types at this collection point
+			 *	@brief Allowed waste types at this collection point (IDs)
 			 */
-			std::vector<std::string> _allowed_waste_types;
+			std::vector<size_t> _allowed_waste_types;
 
 			/*!
 			 *	@brief Driving time from this collection point to the depot
@@ -93,12 +111,6 @@ namespace IVM
 		 */
 		std::vector<Collection_Point> _collection_points;
 
-		/*!
-		 *	@brief	Stores the unloading times for the various types of waste (the same at all facilities)
-		 *			string == type of waste; double == unloading time
-		 */
-		std::unordered_map<std::string, double> _waste_type_unloading_time;
-
 		/*!
 		 *	@brief To store information on the different types of trucks
 		 */
@@ -126,9 +138,9 @@ namespace IVM
 
 			/*!
 			 *	@brief	The capacity of the truck for the various types of waste
-			 *			string == waste type; double == capacity for that type
+			 *			index == waste type ID; double == capacity for that type
 			 */
-			std::unordered_map<std::string, double> _capacities;
+			std::vector<double> _capacities;
 		};
 
 		/*!
@@ -148,38 +160,49 @@ namespace IVM
 
 			/*!
 			 *	@brief	Demand for the various types of waste
-			 *			string == waste type; double == demand for that type
+			 *			index == waste type ID; double == demand for that type
 			 */
-			std::unordered_map<std::string, double> _demands;
+			std::vector<double> _demands;
 
 			/*!
 			 *	@brief	Collection time for the various types of waste
-			 *			string == waste type; double == collection time for that type
+			 *			index == waste type ID; double == collection time for that type
 			 */
-			std::unordered_map<std::string, double> _collection_times;
+			std::vector<double> _collection_times;
 
 			/*!
-			 *	@brief	Current pickup day for the various types of waste
-			 *			string == waste type; double == current pickup day for that type
+			 *	@brief	Current pickup day for the various types of waste, as read (see _current_calendar_tm)
+			 *			size_t == waste type ID; int == current pickup day for that type
 			 */
-			std::unordered_multimap<std::string, int> _current_calendar_day; 
+			std::unordered_multimap<size_t, int> _current_calendar_day; 
 
 			/*!
-			 *	@brief	Current pickup week for the various types of waste
-			 *			string == waste type; double == current pickup week for that type
+			 *	@brief	Current pickup week for the various types of waste, as read (see _current_calendar_tm)
+			 *			size_t == waste type ID; int == current pickup week for that type
 			 */
-			std::unordered_multimap<std::string, int> _current_calendar_week; 
+			std::unordered_multimap<size_t, int> _current_calendar_week; 
 
 			/*!
-			 *	@brief	Driving time from this zone to various destinations
-			 *			string == destination; double == driving time
+			 *	@brief	Driving time from this zone to the depot (-1 if not in the data)
 			 */
-			std::unordered_map<std::string, double> _driving_time;
+			double _driving_time_depot = -1;
 
 			/*!
-			 *	@brief	Days on which a pickup is not allowed
+			 *	@brief	Driving time from this zone to the collection points
+			 *			index == collection point ID; double == driving time (-1 if not in the data)
 			 */
-			std::vector<int> _forbidden_days;
+			std::vector<double> _driving_time_collection_points;
+
+			/*!
+			 *	@brief	Driving time from this zone to other zones (optional, not used in the models)
+			 *			size_t == zone ID; double == driving time
+			 */
+			std::vector<std::pair<size_t, double>> _driving_time_zones;
+
+			/*!
+			 *	@brief	Days on which a pickup is not allowed (bit d == day d of the week)
+			 */
+			uint32_t _forbidden_days = 0;
 		};
 
 		/*!
@@ -187,6 +210,58 @@ namespace IVM
 		 */
 		std::vector<Zone> _zones;
 
+		/*!
+		 *	@brief	For every zone, waste type and collection point: true if another collection point is never worse
+		 *			to unload this waste type after visiting the zone (order: zone, waste type, collection point)
+		 */
+		std::vector<bool> _collection_point_dominated;
+
+		/*!
+		 *	@brief	Find the dominated collection points for every zone and waste type (see collection_point_dominated()).
+		 *			Called after the data are read.
+		 */
+		void compute_collection_point_dominance();
+
+		/*!
+		 *	@brief	Driving times between all locations in the order of the routing models: Z1...Zn, depot, CP1...CPk
+		 *			(row == from, column == to; -1 if not in the data, e.g. between two collection points)
+		 */
+		std::vector<double> _time_driving_ll;
+
+		/*!
+		 *	@brief Demand and collection time for every zone and waste type (order: zone, waste type; 0 if not in the data)
+		 */
+		std::vector<double> _demand_it;
+		std::vector<double> _time_pickup_it;
+
+		/*!
+		 *	@brief Capacity for every truck type and waste type (order: truck type, waste type; 0 if not in the data)
+		 */
+		std::vector<double> _capacity_qt;
+
+		/*!
+		 *	@brief Unloading time for every waste type (the same at all facilities)
+		 */
+		std::vector<double> _time_unloading_t;
+
+		/*!
+		 *	@brief For every collection point and waste type: true if the waste type can be dropped off there (order: collection point, waste type)
+		 */
+		std::vector<bool> _waste_type_allowed_ct;
+
+		/*!
+		 *	@brief	The current calendar h_tmdw as a bitset: one row of _calendar_words words per waste type and zone
+		 *			(order: waste type, zone), with bit d * nb_weeks + w set if there is a pickup on day d of week w
+		 */
+		std::vector<uint64_t> _current_calendar_tm;
+		size_t _calendar_words = 0;
+
+		/*!
+		 *	@brief	Fill the dense matrices above from the data that were read, so that the models can look up
+		 *			the coefficients by index instead of by name. Called after the data are read.
+		 */
+		void compute_dense_matrices();
+
 		///////////////////////////////////////////////////////////////////////
 
 		/*!
@@ -201,14 +276,14 @@ namespace IVM
 		struct Route
 		{
 			/*!
-			 *	@brief	The type of waste picked up on the route
+			 *	@brief	The type of waste picked up on the route (ID)
 			 */
-			std::string _waste_type;
+			size_t _waste_type = 0;
 
 			/*!
-			 *	@brief	The zones that are visited 
+			 *	@brief	The zones that are visited (IDs)
 			 */
-			std::vector<std::string> _pickups;
+			std::vector<size_t> _pickups;
 
 			/*!
 			 *	@brief	The day on which this route is used (index of day)
@@ -231,6 +306,25 @@ namespace IVM
 		 */
 		std::vector<Route> _routes;
 
+		/*!
+		 *	@brief	Route-zone incidence as a bitmatrix: one row of _route_zone_words words per route,
+		 *			with bit m set if the route visits zone m (set by read_routes_xml())
+		 */
+		std::vector<uint64_t> _route_zone_rm;
+		size_t _route_zone_words = 0;
+
+		/*!
+		 *	@brief	The transposed incidence: one row of _zone_route_words words per zone,
+		 *			with bit r set if route r visits the zone (set by read_routes_xml())
+		 */
+		std::vector<uint64_t> _zone_route_mr;
+		size_t _zone_route_words = 0;
+
+		/*!
+		 *	@brief	Build the route-zone incidence bitmatrices for all routes
+		 */
+		void compute_route_zone_incidence();
+
 	public:
 		/*!
 		 *	@brief Obtain data from an XML file
@@ -317,6 +411,13 @@ namespace IVM
 		 */
 		const std::string& waste_type(size_t index) const { return _waste_types[index]; }
 
+		/*!
+		 *	@brief Get the index of a waste type
+		 *  @param	waste_type	The name of the waste type
+		 *  @returns	The index of the waste type
+		 */
+		size_t waste_type_index(const std::string& waste_type) const { return symbol_id(_waste_type_ids, waste_type, "waste type"); }
+
 		/*!
 		 *	@brief Get the name of a zone
 		 *  @param	index	The index for the zone
@@ -324,6 +425,13 @@ namespace IVM
 		 */
 		const std::string& zone_name(size_t index) const { return _zones[index]._name; }
 
+		/*!
+		 *	@brief Get the index of a zone
+		 *  @param	zone	The name of the zone
+		 *  @returns	The index of the zone
+		 */
+		size_t zone_index(const std::string& zone) const { return symbol_id(_zone_ids, zone, "zone"); }
+
 		/*!
 		 *	@brief Get the name of a truck type
 		 *  @param	index	The index for the truck type
@@ -338,13 +446,58 @@ namespace IVM
 		 */
 		const std::string& collection_point_name(size_t index) const { return _collection_points[index]._name; }
 
+		/*!
+		 *	@brief Get the index of a collection point
+		 *  @param	collection_point	The name of the collection point
+		 *  @returns	The index of the collection point
+		 */
+		size_t collection_point_index(const std::string& collection_point) const { return symbol_id(_collection_point_ids, collection_point, "collection point"); }
+
+		/*!
+		 *	@brief Get the number of locations in the routing models (zones, depot and collection points)
+		 *  @returns	The number of locations
+		 */
+		size_t nb_locations() const { return _zones.size() + 1 + _collection_points.size(); }
+
+		/*!
+		 *	@brief Get the driving time between two locations
+		 *  @param	from	The index of the location in the order Z1...Zn, depot, CP1...CPk
+		 *  @param	to		The index of the location in the same order
+		 *  @returns	The driving time (-1 if not in the data)
+		 */
+		double time_driving(size_t from, size_t to) const { return _time_driving_ll[from * nb_locations() + to]; }
+
 		/*!
 		 *	@brief Find out whether a certain type of waste can be dropped off at a certain collection
 		 *  @param	index	The index for the collection point
 		 *  @param	waste_type	The name of the type of waste
 		 *  @returns	True if the given type of waste can be dropped off at this collection point, false otherwise
 		 */
-		bool collection_point_waste_type_allowed(size_t index, const std::string& waste_type) const;
+		bool collection_point_waste_type_allowed(size_t index, const std::string& waste_type) const { return collection_point_waste_type_allowed(index, waste_type_index(waste_type)); }
+
+		/*!
+		 *	@brief Find out whether a certain type of waste can be dropped off at a certain collection
+		 *  @param	index	The index for the collection point
+		 *  @param	waste_type	The index for the type of waste
+		 *  @returns	True if the given type of waste can be dropped off at this collection point, false otherwise
+		 */
+		bool collection_point_waste_type_allowed(size_t index, size_t waste_type) const { return _waste_type_allowed_ct[index * _waste_types.size() + waste_type]; }
+
+		/*!
+		 *	@brief	Find out whether a collection point is dominated for a zone and a type of waste: another collection
+		 *			point A accepts the same types of waste, and driving from the zone via A to the next stop (any zone
+		 *			or the depot) is never slower than via this collection point (ties are broken by index).
+		 *			Unloading this waste at A instead never makes a route longer, so the arc from the zone to this
+		 *			collection point can be left out of the routing models without changing the optimum.
+		 *  @param	zone				The index for the zone
+		 *  @param	waste_type			The index for the type of waste
+		 *  @param	collection_point	The index for the collection point
+		 *  @returns	True if the collection point is dominated
+		 */
+		bool collection_point_dominated(size_t zone, size_t waste_type, size_t collection_point) const
+		{
+			return _collection_point_dominated[(zone * _waste_types.size() + waste_type) * _collection_points.size() + collection_point];
+		}
 
 		/*!
 		 *	@brief Get the demand for a given waste type in a given zone
@@ -352,7 +505,15 @@ namespace IVM
 		 *  @param	waste_type	The name of the waste type
 		 *  @returns	The demand in the given zone for the given waste type
 		 */
-		double demand(int zone, const std::string& waste_type) const { return _zones[zone]._demands.at(waste_type); }
+		double demand(int zone, const std::string& waste_type) const { return demand(static_cast<size_t>(zone), waste_type_index(waste_type)); }
+
+		/*!
+		 *	@brief Get the demand for a given waste type in a given zone
+		 *  @param	zone	The index for the zone
+		 *  @param	waste_type	The index for the waste type
+		 *  @returns	The demand in the given zone for the given waste type
+		 */
+		double demand(size_t zone, size_t waste_type) const { return _demand_it[zone * _waste_types.size() + waste_type]; }
 
 		/*!
 		 *	@brief Check whether there is a pickup on a certain day of a given week for a given waste type in a given zone
@@ -362,7 +523,21 @@ namespace IVM
 		 *  @param	week	The index for the week
 		 *  @returns	True if there is a pickup on that day, false if not
 		 */
-		bool current_calendar(size_t zone, const std::string& waste_type, size_t day, size_t week) const;
+		bool current_calendar(size_t zone, const std::string& waste_type, size_t day, size_t week) const { return current_calendar(zone, waste_type_index(waste_type), day, week); }
+
+		/*!
+		 *	@brief Check whether there is a pickup on a certain day of a given week for a given waste type in a given zone
+		 *  @param	zone	The index for the zone
+		 *  @param	waste_type	The index for the waste type
+		 *  @param	day	The index for the day
+		 *  @param	week	The index for the week
+		 *  @returns	True if there is a pickup on that day, false if not
+		 */
+		bool current_calendar(size_t zone, size_t waste_type, size_t day, size_t week) const
+		{
+			const size_t bit = day * _nb_weeks + week;
+			return (_current_calendar_tm[(waste_type * _zones.size() + zone) * _calendar_words + bit / 64] >> (bit % 64)) & 1;
+		}
 
 		/*!
 		 *	@brief Check whether pickups are forbidden in a given zone on a given day
@@ -370,7 +545,7 @@ namespace IVM
 		 *  @param	day		The day
 		 *  @returns	True if pickups are forbidden, false otherwise
 		 */
-		bool zone_forbidden_day(size_t zone, size_t day) const;
+		bool zone_forbidden_day(size_t zone, size_t day) const { return day < 32 && ((_zones[zone]._forbidden_days >> day) & 1); }
 
 		/*!
 		 *	@brief Get the number of pickups in the current calendar
@@ -398,21 +573,43 @@ namespace IVM
 		 *  @param	collection_point	The name of the collection point
 		 *  @returns	The driving time
 		 */
-		double time_driving_zone_collectionpoint(size_t zone, const std::string& collection_point) const { return _zones[zone]._driving_time.at(collection_point); }
+		double time_driving_zone_collectionpoint(size_t zone, const std::string& collection_point) const { return time_driving_zone_collectionpoint(zone, collection_point_index(collection_point)); }
+
+		/*!
+		 *	@brief Get the driving time from a given zone to a given collection point
+		 *  @param	zone	The index for the zone
+		 *  @param	collection_point	The index for the collection point
+		 *  @returns	The driving time
+		 */
+		double time_driving_zone_collectionpoint(size_t zone, size_t collection_point) const { return time_driving(zone, _zones.size() + 1 + collection_point); }
 
 		/*!
 		 *	@brief Get the driving time from a given zone to the depot
 		 *  @param	index	The index for the zone
 		 *  @returns	The driving time
 		 */
-		double time_driving_zone_depot(size_t zone) const { return _zones[zone]._driving_time.at("Depot"); }
+		double time_driving_zone_depot(size_t zone) const { return time_driving(zone, _zones.size()); }
 
 		/*!
 		 *	@brief Get the driving time from a given collection point to the depot
 		 *  @param	index	The index for the collection point
 		 *  @returns	The driving time
 		 */
-		double time_driving_collectionpoint_depot(size_t index) const { return _collection_points[index]._driving_time_depot; }
+		double time_driving_collectionpoint_depot(size_t index) const { return time_driving(_zones.size() + 1 + index, _zones.size()); }
+
+		/*!
+		 *	@brief Get the collection points ordered by driving time from a given zone (nearest first)
+		 *  @param	zone	The index for the zone
+		 *  @returns	The indices of the collection points
+		 */
+		std::vector<size_t> collection_points_by_driving_time(size_t zone) const;
+
+		/*!
+		 *	@brief Get a percentile of the driving times from the zones to the depot
+		 *  @param	percentile	The percentile (0-100)
+		 *  @returns	The driving time: this percentage of the zones is at most this far from the depot
+		 */
+		double time_driving_zone_depot_percentile(double percentile) const;
 
 		/*!
 		 *	@brief Get the pickup time per unit of waste for a given type of waste at a given zone
@@ -420,14 +617,29 @@ namespace IVM
 		 *  @param	waste_type	The name of the waste time
 		 *  @returns	The pickup time
 		 */
-		double time_pickup(size_t zone, const std::string& waste_type) const { return _zones[zone]._collection_times.at(waste_type); }
+		double time_pickup(size_t zone, const std::string& waste_type) const { return time_pickup(zone, waste_type_index(waste_type)); }
+
+		/*!
+		 *	@brief Get the pickup time per unit of waste for a given type of waste at a given zone
+		 *  @param	zone	The index for the zone
+		 *  @param	waste_type	The index for the waste type
+		 *  @returns	The pickup time
+		 */
+		double time_pickup(size_t zone, size_t waste_type) const { return _time_pickup_it[zone * _waste_types.size() + waste_type]; }
 
 		/*!
 		 *	@brief Get the (fixed) unloading time for a given type of waste 
 		 *  @param	waste_type	The name of the type of waste
 		 *  @returns	The unloading time
 		 */
-		double time_unloading(const std::string& waste_type) const { return _waste_type_unloading_time.at(waste_type); }
+		double time_unloading(const std::string& waste_type) const { return time_unloading(waste_type_index(waste_type)); }
+
+		/*!
+		 *	@brief Get the (fixed) unloading time for a given type of waste
+		 *  @param	waste_type	The index for the type of waste
+		 *  @returns	The unloading time
+		 */
+		double time_unloading(size_t waste_type) const { return _time_unloading_t[waste_type]; }
 
 		/*!
 		 *	@brief Get the maximum driving time for a given type of truck
@@ -442,7 +654,15 @@ namespace IVM
 		 *  @param	waste_type	The name of the type of waste
 		 *  @returns	The capacity
 		 */
-		double capacity(size_t truck_type, const std::string& waste_type) const { return _trucks[truck_type]._capacities.at(waste_type); }
+		double capacity(size_t truck_type, const std::string& waste_type) const { return capacity(truck_type, waste_type_index(waste_type)); }
+
+		/*!
+		 *	@brief Get the capacity of a given type of truck for a given type of waste
+		 *  @param	truck_type	The index for the type of truck
+		 *  @param	waste_type	The index for the type of waste
+		 *  @returns	The capacity (0 if the truck type cannot carry this waste type)
+		 */
+		double capacity(size_t truck_type, size_t waste_type) const { return _capacity_qt[truck_type * _waste_types.size() + waste_type]; }
 
 		/*!
 		 *	@brief Get the solution from the allocation model
@@ -479,14 +699,38 @@ namespace IVM
 		 *  @param	index_zone		The index for the zone
 		 *  @returns	True if the route visits the zone, false otherwise
 		 */
-		bool route_visits_zone(size_t index_route, size_t index_zone) const;
+		bool route_visits_zone(size_t index_route, size_t index_zone) const
+		{
+			return (_route_zone_rm[index_route * _route_zone_words + index_zone / 64] >> (index_zone % 64)) & 1;
+		}
+
+		/*!
+		 *	@brief	Get the zones that are visited by at least one route of a set of routes
+		 *  @param	routes		The indices of the routes
+		 *  @returns	A bitset with bit m set if zone m is visited (words of 64 bits)
+		 */
+		std::vector<uint64_t> zones_visited_by_routes(const std::vector<size_t>& routes) const;
+
+		/*!
+		 *	@brief	Get the routes that visit a given zone
+		 *  @param	index_zone		The index for the zone
+		 *  @returns	The indices of the routes, in increasing order
+		 */
+		std::vector<size_t> routes_visiting_zone(size_t index_zone) const;
 
 		/*!
 		 *	@brief	Get the name of the waste type that is picked up on the route
 		 *  @param	index_route		The index for the route
 		 *  @returns	The name of the waste type
 		 */
-		const std::string& route_waste_type_name(size_t index_route) const { return _routes[index_route]._waste_type; }
+		const std::string& route_waste_type_name(size_t index_route) const { return _waste_types[_routes[index_route]._waste_type]; }
+
+		/*!
+		 *	@brief	Get the index of the waste type that is picked up on the route
+		 *  @param	index_route		The index for the route
+		 *  @returns	The index of the waste type
+		 */
+		size_t route_waste_type_index(size_t index_route) const { return _routes[index_route]._waste_type; }
 
 		/*!
 		 *	@brief	See if a route picks up a given type of waste
@@ -494,7 +738,7 @@ namespace IVM
 		 *  @param	waste_type		Name of the waste type
 		 *  @returns	True if the route picks up the given type of waste, false otherwise
 		 */
-		bool route_waste_type(size_t index_route, const std::string& waste_type) const { return (_routes[index_route]._waste_type == waste_type); }
+		bool route_waste_type(size_t index_route, const std::string& waste_type) const { return (_routes[index_route]._waste_type == waste_type_index(waste_type)); }
 
 	};
 }
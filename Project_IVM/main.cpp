@@ -11,6 +11,7 @@
 #include <iostream>
 #include <exception>
 #include <stdexcept>
+#include <algorithm>
 
 
 
@@ -37,10 +38,27 @@ int main(int argc, char* argv[])
 			("maxafwijkingen", "Percentage maximale afwijkingen tov huidige kalender", cxxopts::value<double>())
 			("maxtrucks", "Het maximale aantal trucks in de routeoptimalisatie (te weinig = infeasible)", cxxopts::value<int>())
 			("maxsegmenten", "Het maximale aantal segmenten per route (minimaal 3)", cxxopts::value<int>())
+			("parallel-days", "Het aantal dagen dat gelijktijdig wordt opgelost (routing), elk met een deel van de processorkernen", cxxopts::value<int>())
+			("reuse-model", "Bouw het routingmodel een keer en pas het aan voor elke dag", cxxopts::value<bool>())
+			("cross-day-starts", "Gebruik de oplossing van de meest gelijkaardige dag als startoplossing (routing)", cxxopts::value<bool>())
+			("fao-workers", "Het aantal buurten dat gelijktijdig wordt doorzocht (geintegreerd_fao), elk met een deel van de processorkernen", cxxopts::value<int>())
+			("seed", "Seed voor de willekeurige keuzes in fix-and-optimize (voor reproduceerbare benchmarks)", cxxopts::value<unsigned>())
+			("fao-lp-guided", "Kies de vrij te maken dagen, voertuigen en zones op basis van de LP-relaxatie (geintegreerd_fao)", cxxopts::value<bool>())
 			("maxbezoeken", "Het maximale aantal bezoeken over de horizon (geintegreerd model)", cxxopts::value<int>())
 			("ck", "De doelfunctiecoefficient voor afwijkingen tov de huidige kalender (model 3)", cxxopts::value<double>())
 			("cb", "De doelfunctiecoefficient voor het maximale aantal trucks (model 3)", cxxopts::value<double>())
 			("cs", "De doelfunctiecoefficient voor het maximale aantal bezoeken per zone (model 3)", cxxopts::value<double>())
+			("c3", "Generatie van restrictie 3 (allocatiepost): 0 == voor alle r,t,m,d,w, 1 == enkel bezochte zones (standaard), 2 == geaggregeerd per t,m,d,w", cxxopts::value<int>())
+			("benchmark-c3", "Los het model op met elke generatie van restrictie 3 en vergelijk rijen, bouwtijd en rekentijd (allocatiepost)", cxxopts::value<bool>())
+			("export-model", "Schrijf het model weg naar een gecomprimeerd sav-bestand (enkel voor debugging)", cxxopts::value<bool>())
+			("namen", "Geef de variabelen en restricties in het model een naam (enkel voor debugging)", cxxopts::value<bool>())
+			("benchmark", "Meet enkel de bouwtijd van het model (in bulk tov een oproep per variabele/restrictie)", cxxopts::value<bool>())
+			("symmetrie", "Symmetriebreking voor identieke trucks (0 == geen, 1 == volgorde gebruikte trucks, 2 == ook volgorde rijtijden, 3 == ook symmetriebreking CPLEX)", cxxopts::value<int>())
+			("dag-symmetrie", "Sorteer uitwisselbare dagen (zelfde verboden zones) volgens de opgehaalde hoeveelheid (geintegreerd model)", cxxopts::value<bool>())
+			("arc-k", "Heuristiek: elke zone behoudt enkel de bogen naar de k dichtste containerparken (0 == alle, routing en geintegreerd)", cxxopts::value<int>())
+			("arc-depot-percentiel", "Heuristiek: enkel zones binnen dit percentiel van de rijtijden naar het depot kunnen de eerste zone van een route zijn (0-100)", cxxopts::value<double>())
+			("arc-reprice", "Bereken na het oplossen de gereduceerde kosten van de weggelaten bogen (LP-relaxatie)", cxxopts::value<bool>())
+			("benchmark-symmetrie", "Los het model op met elk niveau van symmetriebreking en vergelijk knopen en rekentijd (routing en geintegreerd)", cxxopts::value<bool>())
 			("help", "Uitleg programma");
 
 		auto result = options.parse(argc, argv);
@@ -67,9 +85,41 @@ int main(int argc, char* argv[])
 		if (result.count("output"))
 			output = true;
 
-		bool lpbestand = false;
-		if (result.count("lpbestand"))
-			lpbestand = true;
+		bool exportmodel = false;
+		if (result.count("export-model"))
+			exportmodel = true;
+
+		bool namen = false;
+		if (result.count("namen"))
+			namen = true;
+
+		bool benchmark = false;
+		if (result.count("benchmark"))
+			benchmark = true;
+
+		int symmetrie = IVM::SYMMETRY_NONE;
+		if (result.count("symmetrie"))
+			symmetrie = std::min(std::max(result["symmetrie"].as<int>(), static_cast<int>(IVM::SYMMETRY_NONE)), static_cast<int>(IVM::SYMMETRY_ORDER_AND_CPLEX));
+
+		bool dagsymmetrie = false;
+		if (result.count("dag-symmetrie"))
+			dagsymmetrie = true;
+
+		size_t arck = 0;
+		if (result.count("arc-k"))
+			arck = static_cast<size_t>(std::max(result["arc-k"].as<int>(), 0));
+
+		double arcdepotpercentiel = 100;
+		if (result.count("arc-depot-percentiel"))
+			arcdepotpercentiel = std::min(std::max(result["arc-depot-percentiel"].as<double>(), 0.0), 100.0);
+
+		bool arcreprice = false;
+		if (result.count("arc-reprice"))
+			arcreprice = true;
+
+		bool benchmarksymmetrie = false;
+		if (result.count("benchmark-symmetrie"))
+			benchmarksymmetrie = true;
 
 
 		if (model == "allocatiepre")
@@ -100,7 +150,12 @@ int main(int argc, char* argv[])
 			model.set_fraction_allowed_deviations(maxdev);
 			model.set_max_computation_time(rekentijd);
 			model.set_solver_output_on(output);
-			model.run(data);
+			model.set_export_model(exportmodel);
+			model.set_model_names(namen);
+			if (benchmark)
+				model.benchmark_build(data);
+			else
+				model.run(data);
 		}
 		else if (model == "routing")
 		{
@@ -116,6 +171,18 @@ int main(int argc, char* argv[])
 			if (result.count("kalender"))
 				calendarfile = result["kalender"].as<std::string>();
 
+			int paralleldays = 1;
+			if (result.count("parallel-days"))
+				paralleldays = std::max(result["parallel-days"].as<int>(), 1);
+
+			bool reusemodel = false;
+			if (result.count("reuse-model"))
+				reusemodel = true;
+
+			bool crossdaystarts = false;
+			if (result.count("cross-day-starts"))
+				crossdaystarts = true;
+
 			IVM::Instance data;
 			data.read_data_xml(datafile);
 			data.read_allocation_xml(calendarfile);
@@ -125,14 +192,26 @@ int main(int argc, char* argv[])
 			model.set_max_nb_segments(maxsegmenten);
 			model.set_max_computation_time(rekentijd);
 			model.set_solver_output_on(output);
-
-			double totobjval = 0;
-			for (auto d = 0; d < data.nb_weeks() * data.nb_days(); ++d)
+			model.set_reuse_model(reusemodel);
+			model.set_cross_day_starts(crossdaystarts);
+			model.set_symmetry_breaking(symmetrie);
+			model.set_arc_sparsification(arck, arcdepotpercentiel, arcreprice);
+			model.set_export_model(exportmodel);
+			model.set_model_names(namen);
+
+			if (benchmark)
+			{
+				model.benchmark_build(data, 0);
+			}
+			else if (benchmarksymmetrie)
+			{
+				model.benchmark_symmetry_breaking(data, 0);
+			}
+			else
 			{
-				model.run(data, d);
-				totobjval += model.objective_value();
+				model.run_all_days(data, paralleldays);
+				std::cout << "\n\nTotale kosten alle dagen samen: " << model.objective_value();
 			}
-			std::cout << "\n\nTotale kosten alle dagen samen: " << totobjval;
 		}
 		else if (model == "allocatiepost")
 		{
@@ -161,6 +240,14 @@ int main(int argc, char* argv[])
 			if (result.count("cs"))
 				coefftheta = result["cs"].as<double>();
 
+			int c3 = IVM::IP_model_allocation_post::C3_SPARSE;
+			if (result.count("c3"))
+				c3 = std::min(std::max(result["c3"].as<int>(), static_cast<int>(IVM::IP_model_allocation_post::C3_DENSE)), static_cast<int>(IVM::IP_model_allocation_post::C3_AGGREGATED));
+
+			bool benchmarkc3 = false;
+			if (result.count("benchmark-c3"))
+				benchmarkc3 = true;
+
 
 			IVM::Instance data;
 			data.read_data_xml(datafile);
@@ -171,9 +258,17 @@ int main(int argc, char* argv[])
 			model.set_coefficient_z_tmdw(coeffz);
 			model.set_coefficient_beta(coeffbeta);
 			model.set_coefficient_theta(coefftheta);
+			model.set_c3_generation(c3);
 			model.set_max_computation_time(rekentijd);
 			model.set_solver_output_on(output);
-			model.run(data);
+			model.set_export_model(exportmodel);
+			model.set_model_names(namen);
+			if (benchmark)
+				model.benchmark_build(data);
+			else if (benchmarkc3)
+				model.benchmark_c3_generation(data);
+			else
+				model.run(data);
 		}
 		else if (model == "geintegreerd")
 		{
@@ -198,7 +293,17 @@ int main(int argc, char* argv[])
 			model.set_max_computation_time(rekentijd);
 			model.set_max_visits(maxvisits);
 			model.set_solver_output_on(output);
-			model.run(data);
+			model.set_export_model(exportmodel);
+			model.set_model_names(namen);
+			model.set_symmetry_breaking(symmetrie);
+			model.set_arc_sparsification(arck, arcdepotpercentiel, arcreprice);
+			model.set_day_symmetry_breaking(dagsymmetrie);
+			if (benchmark)
+				model.benchmark_build(data);
+			else if (benchmarksymmetrie)
+				model.benchmark_symmetry_breaking(data);
+			else
+				model.run(data);
 		}
 		else if (model == "geintegreerd_fao")
 		{
@@ -214,6 +319,18 @@ int main(int argc, char* argv[])
 			if (result.count("rekentijd_subprobleem"))
 				max_time_subproblem = result["rekentijd_subprobleem"].as<double>();
 
+			int faoworkers = 1;
+			if (result.count("fao-workers"))
+				faoworkers = std::max(result["fao-workers"].as<int>(), 1);
+
+			bool faolpguided = false;
+			if (result.count("fao-lp-guided"))
+				faolpguided = true;
+
+			unsigned seed = 0;
+			if (result.count("seed"))
+				seed = result["seed"].as<unsigned>();
+
 			int maxvisits = 1;
 			if (result.count("maxbezoeken"))
 				maxvisits = result["maxbezoeken"].as<int>();
@@ -226,9 +343,20 @@ int main(int argc, char* argv[])
 			model.set_max_nb_segments(maxsegmenten);
 			model.set_max_computation_time(rekentijd);
 			model.set_max_computation_time_subproblem(max_time_subproblem);
+			model.set_nb_workers_fao(faoworkers);
+			model.set_seed_fao(seed);
+			model.set_lp_guided_fao(faolpguided);
+			model.set_symmetry_breaking(symmetrie);
+			model.set_arc_sparsification(arck, arcdepotpercentiel, arcreprice);
+			model.set_day_symmetry_breaking(dagsymmetrie);
 			model.set_max_visits(maxvisits);
 			model.set_solver_output_on(output);
-			model.run_fix_and_optimize(data);
+			model.set_export_model(exportmodel);
+			model.set_model_names(namen);
+			if (benchmark)
+				model.benchmark_build(data);
+			else
+				model.run_fix_and_optimize(data);
 		}
 		else
 		{
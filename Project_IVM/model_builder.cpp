@@ -0,0 +1,175 @@
+/*
+	Copyright (c) 2024 KU Leuven
+	Code author: Hendrik Vermuyten
+*/
+
+
+
+#include "model_builder.h"
+#include <stdexcept>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+
+
+namespace IVM
+{
+	///////////////////////////////////////////
+	///			  Model Builder				///
+	///////////////////////////////////////////
+
+	Model_Builder::Model_Builder(CPXENVptr env, CPXLPptr problem, const std::string& caller)
+		: _env(env), _problem(problem), _caller(caller)
+	{
+		_start_time = std::chrono::system_clock::now();
+
+		_nb_columns = CPXgetnumcols(_env, _problem);
+		_nb_rows = CPXgetnumrows(_env, _problem);
+	}
+
+	void Model_Builder::throw_cplex_error(int status, const std::string& what) const
+	{
+		char error_text[CPXMESSAGEBUFSIZE];
+		CPXgeterrorstring(_env, status, error_text);
+		throw std::runtime_error("Error in function " + _caller + ". \n" + what + " \nReason: " + std::string(error_text));
+	}
+
+	int Model_Builder::stage_column(double obj, double lb, double ub, char type)
+	{
+		_col_obj.push_back(obj);
+		_col_lb.push_back(lb);
+		_col_ub.push_back(ub);
+		_col_type.push_back(type);
+
+		const int index = _nb_columns;
+		++_nb_columns;
+
+		if (!_batched)
+			flush_columns();
+
+		return index;
+	}
+
+	void Model_Builder::add_coefficient(size_t index, double value)
+	{
+		if (index >= static_cast<size_t>(_nb_columns))
+			throw std::runtime_error("Error in function " + _caller + ". Index variable exceeds range");
+
+		if (value == 0)
+			return;
+
+		_row_matind.push_back(static_cast<int>(index));
+		_row_matval.push_back(value);
+	}
+
+	int Model_Builder::stage_row(double rhs, char sense)
+	{
+		_row_rhs.push_back(rhs);
+		_row_sense.push_back(sense);
+		_row_matbeg.push_back(static_cast<int>(_row_pending_begin));
+		_row_pending_begin = _row_matind.size();
+
+		const int index = _nb_rows;
+		++_nb_rows;
+
+		if (!_batched)
+			flush_rows();
+
+		return index;
+	}
+
+	void Model_Builder::flush_columns()
+	{
+		if (_col_obj.empty())
+			return;
+
+		std::vector<char*> colname;
+		colname.reserve(_col_name.size());
+		for (auto&& name : _col_name)
+			colname.push_back(const_cast<char*>(name.c_str()));
+
+		int status = CPXnewcols(_env, _problem, static_cast<int>(_col_obj.size()), _col_obj.data(), _col_lb.data(), _col_ub.data(), _col_type.data(), _names ? colname.data() : NULL);
+		if (status != 0)
+			throw_cplex_error(status, "Couldn't add variables.");
+		++_nb_cplex_calls;
+
+		_col_obj.clear();
+		_col_lb.clear();
+		_col_ub.clear();
+		_col_type.clear();
+		_col_name.clear();
+	}
+
+	void Model_Builder::flush_rows()
+	{
+		// constraints can only refer to variables that are known to CPLEX
+		flush_columns();
+
+		if (_row_pending_begin != _row_matind.size())
+			throw std::runtime_error("Error in function " + _caller + ". Coefficients added without constraint");
+
+		if (_row_rhs.empty())
+			return;
+
+		std::vector<char*> rowname;
+		rowname.reserve(_row_name.size());
+		for (auto&& name : _row_name)
+			rowname.push_back(const_cast<char*>(name.c_str()));
+
+		int status = CPXaddrows(_env, _problem, 0, static_cast<int>(_row_rhs.size()), static_cast<int>(_row_matind.size()), _row_rhs.data(), _row_sense.data(),
+			_row_matbeg.data(), _row_matind.data(), _row_matval.data(), NULL, _names ? rowname.data() : NULL);
+		if (status != 0)
+			throw_cplex_error(status, "Couldn't add constraints.");
+		++_nb_cplex_calls;
+		_nb_nonzeroes += _row_matind.size();
+
+		_row_rhs.clear();
+		_row_sense.clear();
+		_row_name.clear();
+		_row_matbeg.clear();
+		_row_matind.clear();
+		_row_matval.clear();
+		_row_pending_begin = 0;
+	}
+
+	double Model_Builder::elapsed_time() const
+	{
+		std::chrono::duration<double, std::ratio<1, 1>> elapsed = std::chrono::system_clock::now() - _start_time;
+		return elapsed.count();
+	}
+
+	double Model_Builder::peak_memory_usage()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+		return 0;
+#else
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) == 0)
+			return usage.ru_maxrss / 1024.0; // in kB on Linux
+		return 0;
+#endif
+	}
+
+	void Model_Builder::print_statistics() const
+	{
+		std::cout << "\nModel built in " << elapsed_time() << " s"
+			<< " (" << _nb_columns << " variables, " << _nb_rows << " constraints, "
+			<< _nb_nonzeroes << " nonzeroes, " << _nb_cplex_calls << " calls to CPLEX, "
+			<< (_names ? "with" : "without") << " names)"
+			<< "\nPeak memory usage (MB): " << peak_memory_usage();
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+}
@@ -0,0 +1,252 @@
+/*
+	Copyright (c) 2024 KU Leuven
+	Code author: Hendrik Vermuyten
+*/
+
+
+
+/*!
+ *  @file       model_builder.h
+ *  @brief      Defines a helper class to assemble CPLEX models in bulk
+ *
+ *  The Model_Builder class stages the variables and constraints of
+ *  a CPLEX model in growable buffers (the constraints in compressed
+ *  sparse row format) and passes them to CPLEX with a small number
+ *  of calls to CPXnewcols and CPXaddrows, instead of one call per
+ *  variable or constraint. The buffers have no fixed size, so there
+ *  is no limit on the number of nonzero coefficients in a constraint.
+ *
+ *  The names of the variables and constraints are passed as functions
+ *  that generate the name. They are only called if names are turned on
+ *  (e.g. to export the model), so that a production build does not
+ *  create any strings and CPLEX does not have to store any names.
+ */
+
+#pragma once
+#ifndef MODEL_BUILDER_H
+#define MODEL_BUILDER_H
+
+#include "ilcplex/cplex.h"
+#include <string>
+#include <vector>
+#include <chrono>
+
+
+
+namespace IVM
+{
+	/*!
+	 *	@brief Stages variables and constraints and adds them to a CPLEX problem in bulk
+	 */
+	class Model_Builder
+	{
+		/*!
+		 *	@brief CPLEX environment pointer
+		 */
+		CPXENVptr _env = nullptr;
+
+		/*!
+		 *	@brief CPLEX LP pointer
+		 */
+		CPXLPptr _problem = nullptr;
+
+		/*!
+		 *	@brief The name of the function that builds the model (used in error messages)
+		 */
+		std::string _caller;
+
+		/*!
+		 *	@brief	If true, variables and constraints are only passed to CPLEX when flushed.
+		 *			If false, every variable and constraint is passed to CPLEX separately (used as a reference in benchmarks).
+		 */
+		bool _batched = true;
+
+		/*!
+		 *	@brief If true, the variables and constraints get a name in the CPLEX model
+		 */
+		bool _names = true;
+
+		/*!
+		 *	@brief Number of variables in the model (including the staged ones)
+		 */
+		int _nb_columns = 0;
+
+		/*!
+		 *	@brief Number of constraints in the model (including the staged ones)
+		 */
+		int _nb_rows = 0;
+
+		/*!
+		 *	@brief Total number of nonzero coefficients passed to the model
+		 */
+		size_t _nb_nonzeroes = 0;
+
+		/*!
+		 *	@brief Number of calls to CPXnewcols and CPXaddrows
+		 */
+		size_t _nb_cplex_calls = 0;
+
+		/*!
+		 *	@brief The moment the builder was created
+		 */
+		std::chrono::time_point<std::chrono::system_clock> _start_time;
+
+		/*!
+		 *	@brief Staged variables: objective coefficients, bounds, types and names
+		 */
+		std::vector<double> _col_obj;
+		std::vector<double> _col_lb;
+		std::vector<double> _col_ub;
+		std::vector<char> _col_type;
+		std::vector<std::string> _col_name;
+
+		/*!
+		 *	@brief Staged constraints: right-hand sides, senses, names and coefficients (CSR format)
+		 */
+		std::vector<double> _row_rhs;
+		std::vector<char> _row_sense;
+		std::vector<std::string> _row_name;
+		std::vector<int> _row_matbeg;
+		std::vector<int> _row_matind;
+		std::vector<double> _row_matval;
+
+		/*!
+		 *	@brief Position in _row_matind of the first coefficient of the constraint that is currently being staged
+		 */
+		size_t _row_pending_begin = 0;
+
+		/*!
+		 *	@brief Stage a new variable (the name is already staged if names are on)
+		 *  @returns	The index of the new variable
+		 */
+		int stage_column(double obj, double lb, double ub, char type);
+
+		/*!
+		 *	@brief Stage a new constraint (the name is already staged if names are on)
+		 *  @returns	The index of the new constraint
+		 */
+		int stage_row(double rhs, char sense);
+
+		/*!
+		 *	@brief Throw an exception with the CPLEX error message
+		 *  @param	status	The status returned by CPLEX
+		 *  @param	what	Description of the action that failed
+		 */
+		void throw_cplex_error(int status, const std::string& what) const;
+
+
+	public:
+		/*!
+		 *	@brief Constructor
+		 *  @param	env		The CPLEX environment
+		 *  @param	problem	The CPLEX problem to which the variables and constraints are added
+		 *  @param	caller	The name of the function that builds the model (used in error messages)
+		 */
+		Model_Builder(CPXENVptr env, CPXLPptr problem, const std::string& caller);
+
+		/*!
+		 *	@brief Pass variables and constraints in bulk or one by one to CPLEX
+		 *  @param	batched		If true, variables and constraints are passed to CPLEX in bulk
+		 */
+		void set_batched(bool batched) { _batched = batched; }
+
+		/*!
+		 *	@brief Give the variables and constraints a name or not
+		 *  @param	names		If true, the name generators are called and the names are passed to CPLEX
+		 */
+		void set_names(bool names) { _names = names; }
+
+		/*!
+		 *	@brief Stage a new variable
+		 *  @param	obj		The objective function coefficient
+		 *  @param	lb		The lower bound
+		 *  @param	ub		The upper bound (CPX_INFBOUND if unbounded)
+		 *  @param	type	The type of the variable ('C', 'B' or 'I')
+		 *  @param	name	Function that returns the name of the variable (only called if names are on)
+		 *  @returns	The index of the new variable
+		 */
+		template<typename Name_Generator>
+		int add_column(double obj, double lb, double ub, char type, Name_Generator&& name)
+		{
+			if (_names)
+				_col_name.push_back(name());
+			return stage_column(obj, lb, ub, type);
+		}
+
+		/*!
+		 *	@brief Add a coefficient to the constraint that is currently being staged
+		 *  @param	index	The index of the variable
+		 *  @param	value	The coefficient of the variable
+		 */
+		void add_coefficient(size_t index, double value);
+
+		/*!
+		 *	@brief Stage a new constraint with the coefficients added since the previous constraint
+		 *  @param	rhs		The right-hand side
+		 *  @param	sense	The sign of the constraint ('L', 'E' or 'G')
+		 *  @param	name	Function that returns the name of the constraint (only called if names are on)
+		 *  @returns	The index of the new constraint
+		 */
+		template<typename Name_Generator>
+		int add_row(double rhs, char sense, Name_Generator&& name)
+		{
+			if (_names)
+				_row_name.push_back(name());
+			return stage_row(rhs, sense);
+		}
+
+		/*!
+		 *	@brief Add all staged variables to the CPLEX problem
+		 */
+		void flush_columns();
+
+		/*!
+		 *	@brief Add all staged variables and constraints to the CPLEX problem
+		 */
+		void flush_rows();
+
+		/*!
+		 *	@brief Get the number of variables in the model
+		 *  @returns The number of variables
+		 */
+		int nb_columns() const { return _nb_columns; }
+
+		/*!
+		 *	@brief Get the number of constraints in the model
+		 *  @returns The number of constraints
+		 */
+		int nb_rows() const { return _nb_rows; }
+
+		/*!
+		 *	@brief Get the number of nonzero coefficients in the model
+		 *  @returns The number of nonzero coefficients
+		 */
+		size_t nb_nonzeroes() const { return _nb_nonzeroes; }
+
+		/*!
+		 *	@brief Get the number of calls to CPXnewcols and CPXaddrows so far
+		 *  @returns The number of calls
+		 */
+		size_t nb_cplex_calls() const { return _nb_cplex_calls; }
+
+		/*!
+		 *	@brief Get the time since the builder was created
+		 *  @returns The elapsed time in seconds
+		 */
+		double elapsed_time() const;
+
+		/*!
+		 *	@brief Get the peak memory usage of the process
+		 *  @returns The peak memory usage in MB
+		 */
+		static double peak_memory_usage();
+
+		/*!
+		 *	@brief Write the size of the model, the build time and the peak memory usage to the screen
+		 */
+		void print_statistics() const;
+	};
+}
+
+
+#endif // !MODEL_BUILDER_H
@@ -39,11 +39,15 @@
 #define MODELS_H
 
 #include "ilcplex/cplex.h"
+#include "variable_layout.h"
 #include <string>
 #include <memory>
 #include <chrono>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
 
 
 
@@ -53,6 +57,18 @@ namespace IVM
 	class Instance;
 
 
+	/*!
+	 *	@brief The levels of symmetry breaking for identical trucks (routing and integrated model)
+	 */
+	enum Symmetry_Breaking
+	{
+		SYMMETRY_NONE,				///< No symmetry breaking
+		SYMMETRY_ORDER_TRUCKS,		///< y_v >= y_v+1: the used trucks come first
+		SYMMETRY_ORDER_DURATION,	///< Also beta_v >= beta_v+1: the used trucks are sorted by route duration
+		SYMMETRY_ORDER_AND_CPLEX,	///< Also the most aggressive symmetry breaking of CPLEX (orbital fixing)
+	};
+
+
 	/*!
 	 *	@brief The model to decide which zones are visited on which days to level the collection amounts
 	 */
@@ -122,6 +138,22 @@ namespace IVM
 		 */
 		bool _output_solver = false;
 
+		/*!
+		 *	@brief	If true, the model is passed to CPLEX in bulk.
+		 *			If false, every variable and constraint is passed separately (reference for benchmark_build()).
+		 */
+		bool _batched_build = true;
+
+		/*!
+		 *	@brief If true, the model is written to a compressed SAV file after it has been built
+		 */
+		bool _export_model = false;
+
+		/*!
+		 *	@brief If true, the variables and constraints get a name in the CPLEX model (always the case if the model is exported)
+		 */
+		bool _model_names = false;
+
 
 	public:
 		/*!
@@ -136,6 +168,18 @@ namespace IVM
          */
 		void set_solver_output_on(bool on) { _output_solver = on; }
 
+		/*!
+		 *	@brief Write the model to a compressed SAV file after it has been built (for debugging)
+		 *  @param	on	If true, the model is exported
+		 */
+		void set_export_model(bool on) { _export_model = on; }
+
+		/*!
+		 *	@brief Give the variables and constraints a name in the CPLEX model (for debugging, costs memory and build time)
+		 *  @param	on	If true, names are generated
+		 */
+		void set_model_names(bool on) { _model_names = on; }
+
 		/*!
 		 *	@brief The possible scenarios
 		 */
@@ -165,6 +209,12 @@ namespace IVM
 		 */
 		double objective_value() const { return _objective_value; }
 
+		/*!
+		 *	@brief Measure the time to build the model in bulk and with one call to CPLEX per variable and constraint
+		 *  @param	data	The problem data
+		 */
+		void benchmark_build(const Instance& data);
+
 		/*!
 		 *	@brief Build and solve the MIP model
 		 *  @param	data	The problem data
@@ -208,11 +258,121 @@ namespace IVM
 		 */
 		void solve_problem(const Instance& data, size_t day);
 
+		/*!
+		 *	@brief	Price the arcs left out by sparsification with the duals of the LP relaxation of the sparse model
+		 *			and report how many of them have a negative reduced cost (and so could improve the solution)
+		 *  @param	data	The problem data
+		 */
+		void price_sparsified_arcs(const Instance& data);
+
+		/*!
+		 *	@brief Get the duration of arc (i,j) for truck type q: driving time, plus the unloading time at a collection point
+		 *  @param	data	The problem data
+		 *  @returns The duration
+		 */
+		double arc_time(const Instance& data, int q, int i, int j) const;
+
 		/*!
 		 *	@brief Release CPLEX memory
 		 */
 		void clear_cplex();
 
+		/*!
+		 *	@brief The solution of one day, as it is written to the output files
+		 */
+		struct Day_Output
+		{
+			bool solved = false;			///< True if a feasible solution was found
+			double objective_value = 0;		///< The objective value of the solution
+			std::string routing;			///< Contents for <instance>_routing.txt
+			std::string routing_alt;		///< Contents for <instance>_routing_alt.txt
+			std::string routing_altshort;	///< Contents for <instance>_routing_altshort.txt
+			std::string trucks;				///< Contents for <instance>_trucks.txt
+			std::string routes_xml;			///< Contents for <instance>_routes.xml
+			std::vector<int> solution_indices;		///< Column indices of the variables with a nonzero value (MIP start for other days)
+			std::vector<double> solution_values;	///< Values of these variables
+			int start_day = -1;					///< The day whose solution was used as MIP start (-1 == no MIP start)
+			double time_first_incumbent = -1;	///< Time (in seconds) until the first feasible solution was found (-1 == none found)
+			double gap = -1;					///< Relative MIP gap at the end of the solve (-1 == no solution)
+		};
+
+		/*!
+		 *	@brief The solution of the last solved day
+		 */
+		Day_Output _day_output;
+
+		/*!
+		 *	@brief Write the solution of a day to the output files (the files are overwritten for day 0 and appended to otherwise)
+		 *  @param	data	The problem data
+		 *  @param	day		The day
+		 *  @param	output	The solution of the day
+		 */
+		void write_day_output(const Instance& data, size_t day, const Day_Output& output) const;
+
+		/*!
+		 *	@brief Print per day the MIP start that was used, the time until the first feasible solution and the final gap
+		 *  @param	outputs	The solutions of the days
+		 */
+		void print_day_statistics(const std::vector<Day_Output>& outputs) const;
+
+		/*!
+		 *	@brief Adapt the model that was built for another day to the given day (right-hand sides of constraint 4 and bounds)
+		 *  @param	data	The problem data
+		 *  @param	day		The day
+		 */
+		void update_day(const Instance& data, size_t day);
+
+		/*!
+		 *	@brief Solve the routing problem for a day (builds a new model, or updates the existing one if the model is reused)
+		 *  @param	data	The problem data
+		 *  @param	day		The day
+		 */
+		void solve_day(const Instance& data, size_t day, int start_day = -1, const Day_Output* start = nullptr);
+
+		/*!
+		 *	@brief	Measure how similar the pickups on two days are (weighted overlap of the allocation vectors x_tmdw).
+		 *			1.0 == identical pickups, 0.0 == no zone and waste type in common
+		 *  @param	data	The problem data
+		 *  @param	day1	The first day
+		 *  @param	day2	The second day
+		 *  @returns The similarity, between 0.0 and 1.0
+		 */
+		static double day_similarity(const Instance& data, size_t day1, size_t day2);
+
+		/*!
+		 *	@brief Find the solved day that is most similar to the given day
+		 *  @param	data	The problem data
+		 *  @param	day		The day
+		 *  @param	outputs	The solutions of the days (only the solved days are considered)
+		 *  @returns The most similar solved day (-1 == no solved day with pickups in common)
+		 */
+		static int most_similar_day(const Instance& data, size_t day, const std::vector<Day_Output>& outputs);
+
+		/*!
+		 *	@brief	Add the solution of another day as a MIP start.
+		 *			Only the trucks that don't visit a zone with different pickups are kept, the other trucks are left to CPLEX.
+		 *  @param	data		The problem data
+		 *  @param	day			The day that is solved next
+		 *  @param	source_day	The day whose solution is used
+		 *  @param	source		The solution of this day
+		 *  @returns True if a MIP start was added
+		 */
+		bool add_mip_start(const Instance& data, size_t day, size_t source_day, const Day_Output& source);
+
+		/*!
+		 *	@brief Bookkeeping of the info callback (time until the first feasible solution)
+		 */
+		struct Incumbent_Log
+		{
+			std::chrono::system_clock::time_point start_time;	///< Start of the solve
+			double time_first_incumbent = -1;					///< Time (in seconds) until the first feasible solution (-1 == none found yet)
+		};
+
+		/*!
+		 *	@brief Info callback that registers when the first feasible solution is found
+		 */
+		static int CPXPUBLIC incumbent_callback(CPXCENVptr env, void* cbdata, int wherefrom, void* cbhandle);
+
 		/*!
 		 *	@brief The available number of trucks
 		 */
@@ -252,6 +412,134 @@ namespace IVM
 		 */
 		bool _output_solver = false;
 
+		/*!
+		 *	@brief The number of threads CPLEX can use (0 == CPLEX decides)
+		 */
+		int _nb_threads = 0;
+
+		/*!
+		 *	@brief If true, the model is built once and only updated for the other days
+		 */
+		bool _reuse_model = false;
+
+		/*!
+		 *	@brief If true, the solution of the most similar solved day is used as MIP start
+		 */
+		bool _cross_day_starts = false;
+
+		/*!
+		 *	@brief The level of symmetry breaking for the trucks of the same type (see Symmetry_Breaking)
+		 */
+		int _symmetry_breaking = SYMMETRY_NONE;
+
+		/*!
+		 *	@brief Sparsification (heuristic): every zone keeps the arcs to its _arc_k nearest collection points (0 == all)
+		 */
+		size_t _arc_k = 0;
+
+		/*!
+		 *	@brief Sparsification (heuristic): only zones within this percentile of the driving times to the depot are the first zone of a route
+		 */
+		double _arc_depot_percentile = 100;
+
+		/*!
+		 *	@brief If true, the arcs left out by sparsification are priced after every solve (see price_sparsified_arcs())
+		 */
+		bool _arc_reprice = false;
+
+		/*!
+		 *	@brief The arcs left out by sparsification for every truck type (set by build_problem())
+		 */
+		std::vector<std::vector<Arc>> _sparsified_arcs_q;
+
+		/*!
+		 *	@brief Row index of the first constraint 4 (the rows for all t,i follow in this order)
+		 */
+		int _startindex_c4_ti = 0;
+
+		/*!
+		 *	@brief Row index of the first constraint 1, 3, 5, 6 and 9 (the rows follow in the order of the indices)
+		 *			and of every constraint 8 (-1 if left out), used to price the arcs left out by sparsification
+		 */
+		int _startindex_c1_qv = 0;
+		int _startindex_c3_tqvik = 0;
+		int _startindex_c5_qv = 0;
+		int _startindex_c6_qv = 0;
+		int _startindex_c9_qvk = 0;
+		std::vector<int> _rowindex_c8_qvik;
+
+		/*!
+		 *	@brief	If true, the model is passed to CPLEX in bulk.
+		 *			If false, every variable and constraint is passed separately (reference for benchmark_build()).
+		 */
+		bool _batched_build = true;
+
+		/*!
+		 *	@brief If true, the model is written to a compressed SAV file after it has been built
+		 */
+		bool _export_model = false;
+
+		/*!
+		 *	@brief If true, the variables and constraints get a name in the CPLEX model (always the case if the model is exported)
+		 */
+		bool _model_names = false;
+
+		/*!
+		 *	@brief The columns of the arc variables x_qvijk, only for the allowed arcs (set by build_problem())
+		 */
+		Arc_Family _layout_x_qvijk;
+
+		/*!
+		 *	@brief Column indices of the first w, y and beta variables in the model (set by build_problem())
+		 */
+		int _startindex_w_tqvik = 0;
+		int _startindex_y_qv = 0;
+		int _startindex_beta_qv = 0;
+
+		/*!
+		 *	@brief Number of truck types, zones and locations in the model (set by build_problem())
+		 */
+		int _nb_truck_types = 0;
+		int _nb_zones = 0;
+		int _nb_locations = 0;
+
+		/*!
+		 *	@brief Get the column index of variable x_qvijk (the arc must be allowed, see _layout_x_qvijk.contains())
+		 */
+		int index_x_qvijk(int q, int v, int i, int j, int k) const { return static_cast<int>(_layout_x_qvijk(q, v, i, j, k)); }
+
+		/*!
+		 *	@brief The block of w_tqvik variables of every pair (t,q), in order t*nb_truck_types + q (-1 if truck type q has no capacity for waste type t)
+		 */
+		std::vector<int> _w_block_tq;
+
+		/*!
+		 *	@brief Check whether truck type q can carry waste type t (only then the variables w_tqvik exist)
+		 */
+		bool compatible_tq(int t, int q) const { return _w_block_tq[t * _nb_truck_types + q] >= 0; }
+
+		/*!
+		 *	@brief Get the column index of variable w_tqvik (i_zone is the index of the zone; t and q must be compatible)
+		 */
+		int index_w_tqvik(int t, int q, int v, int i_zone, int k) const
+		{
+			assert(compatible_tq(t, q) && "Waste type and truck type are not compatible");
+			const int nb_trucks = static_cast<int>(_max_nb_trucks);
+			const int nb_segments = static_cast<int>(_max_nb_segments);
+			return _startindex_w_tqvik + _w_block_tq[t * _nb_truck_types + q] * nb_trucks * _nb_zones * nb_segments
+				+ v * _nb_zones * nb_segments + i_zone * nb_segments + k;
+		}
+
+		/*!
+		 *	@brief Get the column index of variable y_qv
+		 */
+		int index_y_qv(int q, int v) const { return _startindex_y_qv + q * static_cast<int>(_max_nb_trucks) + v; }
+
+		/*!
+		 *	@brief Get the column index of variable beta_qv
+		 */
+		int index_beta_qv(int q, int v) const { return _startindex_beta_qv + q * static_cast<int>(_max_nb_trucks) + v; }
+
 
 	public:
 
@@ -261,6 +549,18 @@ namespace IVM
 		 */
 		void set_solver_output_on(bool on) { _output_solver = on; }
 
+		/*!
+		 *	@brief Write the model to a compressed SAV file after it has been built (for debugging)
+		 *  @param	on	If true, the model is exported
+		 */
+		void set_export_model(bool on) { _export_model = on; }
+
+		/*!
+		 *	@brief Give the variables and constraints a name in the CPLEX model (for debugging, costs memory and build time)
+		 *  @param	on	If true, names are generated
+		 */
+		void set_model_names(bool on) { _model_names = on; }
+
 		/*!
 		 *	@brief Set the maximum number of trucks (for each type)
 		 *  @param	max_nb_trucks	The maximum number of trucks
@@ -291,18 +591,71 @@ namespace IVM
 		 */
 		void set_optimality_tolerance(double optimality_tolerance) { _optimality_tolerance = optimality_tolerance; }
 
+		/*!
+		 *	@brief Set the number of threads CPLEX can use
+		 *  @param	nb_threads	The number of threads (0 == CPLEX decides)
+		 */
+		void set_nb_threads(int nb_threads) { _nb_threads = nb_threads; }
+
+		/*!
+		 *	@brief Build the model once and update it for each day instead of building a new model every day
+		 *  @param	reuse	If true, the model is reused
+		 */
+		void set_reuse_model(bool reuse) { _reuse_model = reuse; }
+
+		/*!
+		 *	@brief Use the solution of the most similar day that was already solved as MIP start (only in run_all_days())
+		 *  @param	on	If true, MIP starts are used
+		 */
+		void set_cross_day_starts(bool on) { _cross_day_starts = on; }
+
+		/*!
+		 *	@brief Set the level of symmetry breaking for identical trucks
+		 *  @param	level	The level (see Symmetry_Breaking)
+		 */
+		void set_symmetry_breaking(int level) { _symmetry_breaking = level; }
+
+		/*!
+		 *	@brief	Sparsify the arcs (heuristic: the solution is no longer guaranteed to be optimal)
+		 *  @param	k					Every zone keeps the arcs to and from its k nearest collection points (0 == all)
+		 *  @param	depot_percentile	Only the zones within this percentile (0-100) of the driving times to the depot can be the first zone of a route
+		 *  @param	reprice				If true, the left out arcs are priced with the LP duals after every solve
+		 */
+		void set_arc_sparsification(size_t k, double depot_percentile, bool reprice) { _arc_k = k; _arc_depot_percentile = depot_percentile; _arc_reprice = reprice; }
+
 		/*!
 		 *	@brief Get the objective value of the solution
 		 *  @returns The objective value
 		 */
 		double objective_value() const { return _objective_value; }
 
+		/*!
+		 *	@brief Measure the time to build the model in bulk and with one call to CPLEX per variable and constraint
+		 *  @param	data	The problem data
+		 *  @param	day		The day for which to build the routing problem
+		 */
+		void benchmark_build(const Instance& data, size_t day);
+
+		/*!
+		 *	@brief Solve the routing problem of a day with every level of symmetry breaking and compare status, nodes and time
+		 *  @param	data	The problem data
+		 *  @param	day		The day for which to solve the routing problem
+		 */
+		void benchmark_symmetry_breaking(const Instance& data, size_t day);
+
 		/*!
 		 *	@brief Build and solve the CPLEX model
 		 *  @param	data	The problem data
 		 *  @param	day		The day for which to build the routing problem
 		 */
 		void run(const Instance& data, size_t day);
+
+		/*!
+		 *	@brief Build and solve the routing problem for all days in the planning horizon
+		 *  @param	data				The problem data
+		 *  @param	nb_parallel_days	The number of days that are solved at the same time (each in its own CPLEX environment)
+		 */
+		void run_all_days(const Instance& data, size_t nb_parallel_days = 1);
 	};
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -380,11 +733,37 @@ namespace IVM
 		 */
 		bool _penalty_on_route_assignment = false;
 
+		/*!
+		 *	@brief How constraint 3 is generated (see C3_Generation)
+		 */
+		int _c3_generation = C3_SPARSE;
+
+		/*!
+		 *	@brief The number of rows of constraint 3 in the last model that was built
+		 */
+		size_t _nb_rows_c3 = 0;
+
 		/*!
 		 *        @brief Print the solver's output to screen
 		 */
 		bool _output_solver = false;
 
+		/*!
+		 *	@brief	If true, the model is passed to CPLEX in bulk.
+		 *			If false, every variable and constraint is passed separately (reference for benchmark_build()).
+		 */
+		bool _batched_build = true;
+
+		/*!
+		 *	@brief If true, the model is written to a compressed SAV file after it has been built
+		 */
+		bool _export_model = false;
+
+		/*!
+		 *	@brief If true, the variables and constraints get a name in the CPLEX model (always the case if the model is exported)
+		 */
+		bool _model_names = false;
+
 
 	public:
 
@@ -398,6 +777,16 @@ namespace IVM
 			FREE_WEEK_FREE_DAY,		///< Vrije keuze van week of dag
 		};
 
+		/*!
+		 *	@brief The ways to generate constraint 3 (a route can only be used on a day if its zones are visited that day)
+		 */
+		enum C3_Generation
+		{
+			C3_DENSE,		///< One row for every r,t,m,d,w (most rows are redundant, reference)
+			C3_SPARSE,		///< x_rdw <= y_tmdw only for the routes r that visit zone m and pick up waste type t
+			C3_AGGREGATED,	///< sum(r) x_rdw <= n_tm y_tmdw for every t,m,d,w with such routes (fewer rows, weaker LP relaxation)
+		};
+
 		/*!
 		 *	@brief Set the scenario
 		 *  @param scenario	The scenario
@@ -434,18 +823,48 @@ namespace IVM
 		 */
 		void set_penalty_route_assignment(bool yes) { _penalty_on_route_assignment = yes; }
 
+		/*!
+		 *	@brief Choose how constraint 3 is generated
+		 *  @param	generation	The way to generate constraint 3 (see C3_Generation)
+		 */
+		void set_c3_generation(int generation) { _c3_generation = generation; }
+
 		/*!
 		 *	@brief Set the output to screen for the solver on/off.
 		 *  @param	on	If true, output is turned on; otherwise output is turned off
 		 */
 		void set_solver_output_on(bool on) { _output_solver = on; }
 
+		/*!
+		 *	@brief Write the model to a compressed SAV file after it has been built (for debugging)
+		 *  @param	on	If true, the model is exported
+		 */
+		void set_export_model(bool on) { _export_model = on; }
+
+		/*!
+		 *	@brief Give the variables and constraints a name in the CPLEX model (for debugging, costs memory and build time)
+		 *  @param	on	If true, names are generated
+		 */
+		void set_model_names(bool on) { _model_names = on; }
+
 		/*!
 		 *	@brief Get the objective value of the solution
 		 *  @returns The objective value
 		 */
 		double objective_value() const { return _objective_value; }
 
+		/*!
+		 *	@brief Measure the time to build the model in bulk and with one call to CPLEX per variable and constraint
+		 *  @param	data	The problem data
+		 */
+		void benchmark_build(const Instance& data);
+
+		/*!
+		 *	@brief Build and solve the model with every way to generate constraint 3 and compare rows, build time and solve time
+		 *  @param	data	The problem data
+		 */
+		void benchmark_c3_generation(const Instance& data);
+
 		/*!
 		 *	@brief Build and solve the MIP model
 		 *  @param	data	The problem data
@@ -509,6 +928,22 @@ namespace IVM
 		 */
 		bool _output_solver = false;
 
+		/*!
+		 *	@brief	If true, the model is passed to CPLEX in bulk.
+		 *			If false, every variable and constraint is passed separately (reference for benchmark_build()).
+		 */
+		bool _batched_build = true;
+
+		/*!
+		 *	@brief If true, the model is written to a compressed SAV file after it has been built
+		 */
+		bool _export_model = false;
+
+		/*!
+		 *	@brief If true, the variables and constraints get a name in the CPLEX model (always the case if the model is exported)
+		 */
+		bool _model_names = false;
+
 		/*!
 		 *	@brief The available number of trucks
 		 */
@@ -526,20 +961,186 @@ namespace IVM
 		 */
 		size_t _max_visits = 1;
 
+		/*!
+		 *	@brief The level of symmetry breaking for the trucks on the same day (see Symmetry_Breaking)
+		 */
+		int _symmetry_breaking = SYMMETRY_NONE;
+
+		/*!
+		 *	@brief If true, interchangeable days are sorted by the total amount picked up
+		 */
+		bool _day_symmetry_breaking = false;
+
+		/*!
+		 *	@brief	Find the classes of interchangeable days: days on which the same zones are forbidden.
+		 *			(The objective function and the other constraints are the same for every day.)
+		 *  @param	data	The problem data
+		 *  @returns The days of every class, in increasing order
+		 */
+		std::vector<std::vector<size_t>> day_symmetry_classes(const Instance& data) const;
+
+		/*!
+		 *	@brief Sparsification (heuristic): every zone keeps the arcs to its _arc_k nearest collection points (0 == all)
+		 */
+		size_t _arc_k = 0;
+
+		/*!
+		 *	@brief Sparsification (heuristic): only zones within this percentile of the driving times to the depot are the first zone of a route
+		 */
+		double _arc_depot_percentile = 100;
+
+		/*!
+		 *	@brief If true, the arcs left out by sparsification are priced after solving (see price_sparsified_arcs())
+		 */
+		bool _arc_reprice = false;
+
+		/*!
+		 *	@brief The arcs left out by sparsification, the same for every day and truck (set by initialize_layout())
+		 */
+		std::vector<Arc> _sparsified_arcs;
+
+		/*!
+		 *	@brief Row index of the first constraint 1, 3, 5, 6 and 9 (the rows follow in the order of the indices)
+		 *			and of every constraint 8 (-1 if left out), used to price the arcs left out by sparsification
+		 */
+		int _startindex_c1_dv = 0;
+		int _startindex_c3_dvik = 0;
+		int _startindex_c5_dv = 0;
+		int _startindex_c6_dv = 0;
+		int _startindex_c9_dvk = 0;
+		std::vector<int> _rowindex_c8_dvik;
+
+		/*!
+		 *	@brief Get the duration of arc (i,j): driving time, plus the unloading time at a collection point
+		 *  @param	data	The problem data
+		 *  @returns The duration
+		 */
+		double arc_time(const Instance& data, int i, int j) const;
+
+		/*!
+		 *	@brief	Price the arcs left out by sparsification with the duals of the LP relaxation of the sparse model
+		 *			and report how many of them have a negative reduced cost (and so could improve the solution)
+		 *  @param	data	The problem data
+		 */
+		void price_sparsified_arcs(const Instance& data);
+
 		/*!
 		 *	@brief The objective value of the solution
 		 */
 		double _objective_value = -1;
 
+		/*!
+		 *	@brief The position of the variables of the model in the columns of the CPLEX problem
+		 */
+		struct Layout
+		{
+			Arc_Family x_dvijk;				///< x_dvijk: truck v on day d drives from location i to j in segment k (allowed arcs only)
+			Variable_Family<4> w_dvik;		///< w_dvik: amount picked up by truck v on day d in zone i in segment k
+			Variable_Family<2> y_dv;		///< y_dv: truck v is used on day d
+			Variable_Family<2> beta_dv;		///< beta_dv: duration of the route of truck v on day d
+			Variable_Family<0> z;			///< z: maximum number of trucks used on a day
+			Variable_Family<2> ksi_di;		///< ksi_di: zone i is visited on day d
+			size_t nb_columns = 0;			///< Total number of variables
+
+			/*!
+			 *	@brief Get all columns that belong to a day (one range per family of variables)
+			 *  @param	d	The day
+			 *  @returns The ranges of columns
+			 */
+			std::array<Column_Range, 5> day(size_t d) const
+			{
+				return { { x_dvijk.slice(d), w_dvik.slice(d), y_dv.slice(d), beta_dv.slice(d), ksi_di.slice(d) } };
+			}
+		};
+
+		/*!
+		 *	@brief The layout of the variables (set by build_problem())
+		 */
+		Layout _layout;
+
+		/*!
+		 *	@brief The number of arc variables left out because of collection point dominance (set by initialize_layout())
+		 */
+		size_t _nb_dominated_arcs = 0;
+
+		/*!
+		 *	@brief Determine the layout of the variables for the given data
+		 *  @param	data	The problem data
+		 */
+		void initialize_layout(const Instance& data);
+
 		/*!
 		 *	@brief The current solution from CPLEX
 		 */
-		std::unique_ptr<double[]> _fao_current_solution_cplex;
+		std::vector<double> _fao_current_solution_cplex;
 
 		/*!
 		 *	@brief The best found solution so far
 		 */
-		std::unique_ptr<double[]> _fao_best_solution_cplex;
+		std::vector<double> _fao_best_solution_cplex;
+
+		/*!
+		 *	@brief The number of workers that search neighborhoods at the same time (each with its own copy of the problem)
+		 */
+		size_t _fao_nb_workers = 1;
+
+		/*!
+		 *	@brief The seed for the random choices in fix-and-optimize (0 == random seed)
+		 */
+		uint64_t _fao_seed = 0;
+
+		/*!
+		 *	@brief The solution status of the last neighborhood (0 == no solution)
+		 */
+		int _fao_solstat = 0;
+
+		/*!
+		 *	@brief The types of neighborhoods in fix-and-optimize
+		 */
+		enum Fao_Neighborhood
+		{
+			FAO_DAYS,				///< Free all variables of some days
+			FAO_VEHICLES,			///< Free all variables of some vehicles
+			FAO_ZONES,				///< Free the visits to some zones
+			FAO_LOCAL_BRANCHING,	///< At most k of the ksi_di and y_dv can differ from the best solution
+			FAO_NB_NEIGHBORHOODS,	///< The number of types of neighborhoods
+		};
+
+		/*!
+		 *	@brief If true, the days, vehicles and zones to free are chosen based on the LP relaxation and the best solution instead of uniformly
+		 */
+		bool _fao_lp_guided = false;
+
+		/*!
+		 *	@brief The solution and the reduced costs of the LP relaxation (set by fao_solve_lp_relaxation())
+		 */
+		std::vector<double> _fao_lp_solution;
+		std::vector<double> _fao_lp_reduced_costs;
+
+		/*!
+		 *	@brief The objective function coefficients of all variables (set by fao_solve_lp_relaxation())
+		 */
+		std::vector<double> _fao_objective_coefficients;
+
+		/*!
+		 *	@brief The number of threads CPLEX can use (0 == CPLEX decides)
+		 */
+		int _nb_threads = 0;
+
+		/*!
+		 *	@brief The state of fix-and-optimize that is shared by the workers
+		 */
+		struct Fao_Search_State
+		{
+			std::atomic<double> objective_value{ 1e20 };	///< Objective value of the best solution (can be read without lock)
+			std::atomic<unsigned> version{ 0 };				///< Incremented every time the best solution improves
+			std::mutex mutex;								///< Protects the best solution and the fixing time
+			std::vector<double> solution;					///< The best solution (only copied on improvement)
+			std::atomic<int> nb_neighborhoods{ 0 };			///< The number of neighborhoods searched by all workers
+			std::atomic<size_t> next_zone{ 0 };				///< First zone of the next block in the initial iteration over the zones
+			std::atomic<bool> stop{ false };				///< Set when a worker fails, the other workers stop after their current neighborhood
+			double fixing_time = 0;							///< Time spent on fixing and releasing variables by all workers (in seconds)
+		};
 
 		/*!
 		 *	@brief Maximum computation time per subproblem
@@ -547,11 +1148,50 @@ namespace IVM
 		double _fao_max_comptime_subproblem = 40;
 
 		/*!
-		 *	@brief Add constraint to fix a variable
+		 *	@brief The variables that are fixed in the current neighborhood (column indices and values)
+		 */
+		std::vector<int> _fao_fixed_indices;
+		std::vector<double> _fao_fixed_values;
+
+		/*!
+		 *	@brief The original lower and upper bounds of all variables (restored after each neighborhood)
+		 */
+		std::vector<double> _fao_lb;
+		std::vector<double> _fao_ub;
+
+		/*!
+		 *	@brief Time spent on fixing and releasing variables (in seconds)
+		 */
+		double _fao_fixing_time = 0;
+
+		/*!
+		 *	@brief Fix a variable for the current neighborhood (the bounds are changed by fao_apply_fixings())
 		 *  @param	index_variable	The index of the variable
 		 *  @param	value	The value of variable
 		 */
-		void fao_fix_variable(size_t index_variable, int value);
+		void fao_fix_variable(size_t index_variable, double value);
+
+		/*!
+		 *	@brief Fix all variables of fao_fix_variable() with one call to CPXchgbds (lower bound == upper bound == value)
+		 */
+		void fao_apply_fixings();
+
+		/*!
+		 *	@brief Restore the original bounds of the fixed variables with one call to CPXchgbds
+		 */
+		void fao_release_fixings();
+
+		/*!
+		 *	@brief Pass the best found solution to CPLEX as MIP start for the next neighborhood (replaces earlier MIP starts)
+		 */
+		void fao_add_mip_start();
+
+		/*!
+		 *	@brief	Solve the current neighborhood subproblem and get the solution in _fao_current_solution_cplex
+		 *  @param	name	The name of the neighborhood (for the error message)
+		 *  @returns The objective value (1e20 if there is no usable solution)
+		 */
+		double fao_solve_subproblem(const char* name);
 
 		/*!
 		 *	@brief Search the neighborhood 'days'
@@ -577,12 +1217,57 @@ namespace IVM
 		 */
 		double fao_search_neighborhood_vehicles(const Instance& data, const std::vector<int>& vehicles_free);
 
+		/*!
+		 *	@brief	Search the local branching neighborhood: one constraint limits the Hamming distance
+		 *			between the binary ksi_di and y_dv and their values in the best solution
+		 *  @param	data	The problem data
+		 *  @param	k		The maximum number of ksi_di and y_dv that can change
+		 *  @returns	The objective value of the solution
+		 */
+		double fao_search_neighborhood_local_branching(const Instance& data, size_t k);
+
 		/*!
 		 *	@brief Use CPLEX to find an initial feasible solution
 		 *  @returns	The objective value of the solution
 		 */
 		double fao_initial_solution_cplex();
 
+		/*!
+		 *	@brief Solve the LP relaxation of the model once (on a copy of the problem) for the guided choice of neighborhoods
+		 */
+		void fao_solve_lp_relaxation();
+
+		/*!
+		 *	@brief	Score how promising it is to free each day, vehicle or zone.
+		 *			Sum of four criteria, each scaled to [0,1]: fractionality of ksi_di/y_dv in the LP relaxation,
+		 *			difference between the LP relaxation and the best solution, gain of flipping ksi_di/y_dv in the best solution
+		 *			according to the LP reduced costs, and the driving costs (beta_dv) in the best solution.
+		 *  @param	data			The problem data
+		 *  @param	neighborhood	The type of neighborhood (days, vehicles or zones)
+		 *  @returns The score of every day, vehicle or zone (higher == more promising)
+		 */
+		std::vector<double> fao_guided_scores(const Instance& data, int neighborhood) const;
+
+		/*!
+		 *	@brief Set the CPLEX parameters for the neighborhood subproblems (time limit, optimality tolerance and MIP emphasis), the same for every worker
+		 */
+		void fao_set_parameters();
+
+		/*!
+		 *	@brief Set the time limit of the next neighborhood subproblem
+		 *  @param	time_limit	The time limit (in seconds)
+		 */
+		void fao_set_time_limit(double time_limit);
+
+		/*!
+		 *	@brief Search neighborhoods until the time limit is reached and share improvements with the other workers
+		 *  @param	data		The problem data
+		 *  @param	state		The state shared by the workers (best solution)
+		 *  @param	start_time	The start of fix-and-optimize
+		 *  @param	seed		The seed for the random choice of neighborhoods of this worker
+		 */
+		void fao_worker(const Instance& data, Fao_Search_State& state, std::chrono::system_clock::time_point start_time, uint64_t seed);
+
 		/*!
 		 *	@brief Write the solution from fix-and-optimize to a file
 		 *  @param	data	The problem data
@@ -610,6 +1295,24 @@ namespace IVM
 		 */
 		void set_max_computation_time_subproblem(double max_computation_time) { _fao_max_comptime_subproblem = max_computation_time; }
 
+		/*!
+		 *	@brief Set the number of workers that search neighborhoods at the same time in fix-and-optimize
+		 *  @param	nb_workers	The number of workers (each with its own CPLEX environment and a part of the cores)
+		 */
+		void set_nb_workers_fao(size_t nb_workers) { _fao_nb_workers = nb_workers; }
+
+		/*!
+		 *	@brief Set the seed for the random choices in fix-and-optimize (for reproducible benchmarks)
+		 *  @param	seed	The seed (0 == random seed)
+		 */
+		void set_seed_fao(uint64_t seed) { _fao_seed = seed; }
+
+		/*!
+		 *	@brief Choose the days, vehicles and zones to free in fix-and-optimize based on the LP relaxation instead of uniformly
+		 *  @param	on	If true, the choice is guided by the LP relaxation
+		 */
+		void set_lp_guided_fao(bool on) { _fao_lp_guided = on; }
+
 		/*!
 		 *	@brief Set the maximum number of trucks (for each type)
 		 *  @param	max_nb_trucks	The maximum number of trucks
@@ -628,12 +1331,44 @@ namespace IVM
 		 */
 		void set_max_visits(size_t max_visits) { _max_visits = max_visits; }
 
+		/*!
+		 *	@brief Set the level of symmetry breaking for identical trucks
+		 *  @param	level	The level (see Symmetry_Breaking)
+		 */
+		void set_symmetry_breaking(int level) { _symmetry_breaking = level; }
+
+		/*!
+		 *	@brief Sort interchangeable days (same forbidden zones) by the total amount picked up
+		 *  @param	on	If true, ordering constraints are added for the days of every class
+		 */
+		void set_day_symmetry_breaking(bool on) { _day_symmetry_breaking = on; }
+
+		/*!
+		 *	@brief	Sparsify the arcs (heuristic: the solution is no longer guaranteed to be optimal)
+		 *  @param	k					Every zone keeps the arcs to and from its k nearest collection points (0 == all)
+		 *  @param	depot_percentile	Only the zones within this percentile (0-100) of the driving times to the depot can be the first zone of a route
+		 *  @param	reprice				If true, the left out arcs are priced with the LP duals after solving
+		 */
+		void set_arc_sparsification(size_t k, double depot_percentile, bool reprice) { _arc_k = k; _arc_depot_percentile = depot_percentile; _arc_reprice = reprice; }
+
 		/*!
 		 *	@brief Set the output to screen for the solver on/off.
 		 *  @param	on	If true, output is turned on; otherwise output is turned off
 		 */
 		void set_solver_output_on(bool on) { _output_solver = on; }
 
+		/*!
+		 *	@brief Write the model to a compressed SAV file after it has been built (for debugging)
+		 *  @param	on	If true, the model is exported
+		 */
+		void set_export_model(bool on) { _export_model = on; }
+
+		/*!
+		 *	@brief Give the variables and constraints a name in the CPLEX model (for debugging, costs memory and build time)
+		 *  @param	on	If true, names are generated
+		 */
+		void set_model_names(bool on) { _model_names = on; }
+
 		/*!
 		 *	@brief Set the optimality tolerance
 		 *  @param	optimality_tolerance	The optimality tolerance (should be between 0.0 and 1.0)
@@ -646,6 +1381,18 @@ namespace IVM
 		 */
 		double objective_value() const { return _objective_value; }
 
+		/*!
+		 *	@brief Measure the time to build the model in bulk and with one call to CPLEX per variable and constraint
+		 *  @param	data	The problem data
+		 */
+		void benchmark_build(const Instance& data);
+
+		/*!
+		 *	@brief Solve the model with every level of symmetry breaking and compare status, nodes and time
+		 *  @param	data	The problem data
+		 */
+		void benchmark_symmetry_breaking(const Instance& data);
+
 		/*!
 		 *	@brief Build and solve the MIP model using a MIP-solver
 		 *  @param	data	The problem data
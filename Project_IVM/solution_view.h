@@ -0,0 +1,140 @@
+/*
+	Copyright (c) 2024 KU Leuven
+	Code author: Hendrik Vermuyten
+*/
+
+
+
+/*!
+ *  @file       solution_view.h
+ *  @brief      Defines a read-only view on the solution of a CPLEX model
+ *
+ *  The Solution_View class gives access to the values returned by
+ *  CPXsolution through the column indices of the variables, i.e.
+ *  the same index computations that are used to build the model,
+ *  so that no names have to be looked up with CPXgetcolindex.
+ *  The nonzeroes() function visits only the variables in a range
+ *  of columns that have a nonzero value in the solution.
+ */
+
+#pragma once
+#ifndef SOLUTION_VIEW_H
+#define SOLUTION_VIEW_H
+
+#include <stdexcept>
+#include <string>
+#include <cmath>
+
+
+
+namespace IVM
+{
+	/*!
+	 *	@brief Read-only access to the values of the variables in a CPLEX solution
+	 */
+	class Solution_View
+	{
+		/*!
+		 *	@brief The values of the variables (as returned by CPXsolution)
+		 */
+		const double* _values = nullptr;
+
+		/*!
+		 *	@brief The number of variables in the model
+		 */
+		int _nb_columns = 0;
+
+
+	public:
+		/*!
+		 *	@brief A variable with a nonzero value
+		 */
+		struct Entry
+		{
+			int index;		///< The column index of the variable
+			double value;	///< The value of the variable
+		};
+
+		/*!
+		 *	@brief Iterator over the nonzero variables in a range of columns
+		 */
+		class Nonzero_Iterator
+		{
+			const double* _values;
+			int _index;
+			int _end;
+			double _tolerance;
+
+			void skip_zeroes() { while (_index < _end && std::abs(_values[_index]) <= _tolerance) ++_index; }
+
+		public:
+			Nonzero_Iterator(const double* values, int index, int end, double tolerance)
+				: _values(values), _index(index), _end(end), _tolerance(tolerance) { skip_zeroes(); }
+
+			Entry operator*() const { return Entry{ _index, _values[_index] }; }
+			Nonzero_Iterator& operator++() { ++_index; skip_zeroes(); return *this; }
+			bool operator!=(const Nonzero_Iterator& other) const { return _index != other._index; }
+		};
+
+		/*!
+		 *	@brief A range of columns of which only the nonzero variables are visited
+		 */
+		class Nonzero_Range
+		{
+			const double* _values;
+			int _begin;
+			int _end;
+			double _tolerance;
+
+		public:
+			Nonzero_Range(const double* values, int begin, int end, double tolerance)
+				: _values(values), _begin(begin), _end(end), _tolerance(tolerance) {}
+
+			Nonzero_Iterator begin() const { return Nonzero_Iterator(_values, _begin, _end, _tolerance); }
+			Nonzero_Iterator end() const { return Nonzero_Iterator(_values, _end, _end, _tolerance); }
+		};
+
+		/*!
+		 *	@brief Constructor
+		 *  @param	values		The values of the variables (as returned by CPXsolution)
+		 *  @param	nb_columns	The number of variables in the model
+		 */
+		Solution_View(const double* values, int nb_columns) : _values(values), _nb_columns(nb_columns) {}
+
+		/*!
+		 *	@brief Get the value of a variable
+		 *  @param	index	The column index of the variable
+		 *  @returns The value of the variable
+		 */
+		double value(int index) const
+		{
+			if (index < 0 || index >= _nb_columns)
+				throw std::out_of_range("Error in function Solution_View::value(). Index variable exceeds range");
+			return _values[index];
+		}
+
+		/*!
+		 *	@brief Get the value of an integer or binary variable
+		 *  @param	index	The column index of the variable
+		 *  @returns The value of the variable, rounded to the nearest integer
+		 */
+		int integer_value(int index) const { return static_cast<int>(std::lround(value(index))); }
+
+		/*!
+		 *	@brief Get the variables with a nonzero value in a range of columns
+		 *  @param	begin		The column index of the first variable in the range
+		 *  @param	end			The column index one past the last variable in the range
+		 *  @param	tolerance	Values with an absolute value up to this tolerance are treated as zero
+		 *  @returns A range that can be used in a range-based for loop
+		 */
+		Nonzero_Range nonzeroes(int begin, int end, double tolerance = 0) const
+		{
+			if (begin < 0 || end > _nb_columns || begin > end)
+				throw std::out_of_range("Error in function Solution_View::nonzeroes(). Index variable exceeds range");
+			return Nonzero_Range(_values, begin, end, tolerance);
+		}
+	};
+}
+
+
+#endif // !SOLUTION_VIEW_H
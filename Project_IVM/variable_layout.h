@@ -0,0 +1,402 @@
+/*
+	Copyright (c) 2024 KU Leuven
+	Code author: Hendrik Vermuyten
+*/
+
+
+
+/*!
+ *  @file       variable_layout.h
+ *  @brief      Defines the position of families of variables in the columns of a CPLEX model
+ *
+ *  A Variable_Family describes a family of variables with a fixed number
+ *  of indices (e.g. x_dvijk has 5 indices) that occupies a contiguous block
+ *  of columns in the CPLEX model, with the last index running fastest.
+ *  The column index of a variable is computed in size_t arithmetic, so
+ *  it cannot overflow on large instances. The indices are checked with
+ *  assert() in debug builds; in release builds the computation is a
+ *  plain sum of products without branches.
+ *
+ *  Because the first index runs slowest, all variables of a family with
+ *  the same first index (e.g. all w_dvik of day d) form a contiguous
+ *  Column_Range, which can be iterated over or passed to CPLEX at once.
+ *
+ *  The arc variables x_dvijk (x_qvijk in the routing model) are stored in
+ *  an Arc_Family instead: only the arcs (i,j,k) that a route can use get
+ *  a column, so most of the dense L x L x K block is never created. The
+ *  columns still run over the first index (day or truck type) and the
+ *  truck slowest, so slices per day and per truck remain contiguous.
+ */
+
+#pragma once
+#ifndef VARIABLE_LAYOUT_H
+#define VARIABLE_LAYOUT_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+
+
+namespace IVM
+{
+	/*!
+	 *	@brief A contiguous range of column indices [first, last)
+	 */
+	struct Column_Range
+	{
+		size_t first = 0;	///< The first column in the range
+		size_t last = 0;	///< One past the last column in the range
+
+		/*!
+		 *	@brief Iterator over the column indices in the range
+		 */
+		class Iterator
+		{
+			size_t _index;
+
+		public:
+			explicit Iterator(size_t index) : _index(index) {}
+			size_t operator*() const { return _index; }
+			Iterator& operator++() { ++_index; return *this; }
+			bool operator!=(const Iterator& other) const { return _index != other._index; }
+		};
+
+		Iterator begin() const { return Iterator(first); }
+		Iterator end() const { return Iterator(last); }
+
+		/*!
+		 *	@brief Get the number of columns in the range
+		 *  @returns The number of columns
+		 */
+		size_t size() const { return last - first; }
+
+		/*!
+		 *	@brief Check whether a column belongs to the range
+		 *  @param	index	The column index
+		 *  @returns True if the column is in the range
+		 */
+		bool contains(size_t index) const { return index >= first && index < last; }
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	/*!
+	 *	@brief A family of variables with Rank indices that occupies a contiguous block of columns
+	 */
+	template<size_t Rank>
+	class Variable_Family
+	{
+		/*!
+		 *	@brief The column index of the first variable of the family
+		 */
+		size_t _start = 0;
+
+		/*!
+		 *	@brief The number of values of each index
+		 */
+		std::array<size_t, Rank> _dimensions{};
+
+		/*!
+		 *	@brief The distance between two consecutive values of each index
+		 */
+		std::array<size_t, Rank> _strides{};
+
+		/*!
+		 *	@brief The number of variables in the family
+		 */
+		size_t _size = 1;
+
+	public:
+		/*!
+		 *	@brief Default constructor (empty family at column 0)
+		 */
+		Variable_Family() = default;
+
+		/*!
+		 *	@brief Constructor
+		 *  @param	start		The column index of the first variable of the family
+		 *  @param	dimensions	The number of values of each index
+		 */
+		Variable_Family(size_t start, const std::array<size_t, Rank>& dimensions)
+			: _start(start), _dimensions(dimensions)
+		{
+			for (size_t n = Rank; n-- > 0; )
+			{
+				_strides[n] = _size;
+				_size *= _dimensions[n];
+			}
+		}
+
+		/*!
+		 *	@brief Get the column index of a variable
+		 *  @param	indices		The indices of the variable (as many as the rank of the family)
+		 *  @returns The column index
+		 */
+		template<typename... Indices>
+		size_t operator()(Indices... indices) const
+		{
+			static_assert(sizeof...(Indices) == Rank, "Wrong number of indices for this family of variables");
+			const std::array<size_t, Rank> idx{ { static_cast<size_t>(indices)... } };
+
+			size_t index = _start;
+			for (size_t n = 0; n < Rank; ++n)
+			{
+				assert(idx[n] < _dimensions[n] && "Index variable exceeds range");
+				index += idx[n] * _strides[n];
+			}
+			return index;
+		}
+
+		/*!
+		 *	@brief Get the column index of the first variable of the family
+		 *  @returns The column index
+		 */
+		size_t start() const { return _start; }
+
+		/*!
+		 *	@brief Get the column index one past the last variable of the family
+		 *  @returns The column index
+		 */
+		size_t end() const { return _start + _size; }
+
+		/*!
+		 *	@brief Get the number of variables in the family
+		 *  @returns The number of variables
+		 */
+		size_t size() const { return _size; }
+
+		/*!
+		 *	@brief Get the number of values of an index
+		 *  @param	n	The position of the index
+		 *  @returns The number of values
+		 */
+		size_t dimension(size_t n) const { assert(n < Rank); return _dimensions[n]; }
+
+		/*!
+		 *	@brief Get all columns of the family
+		 *  @returns The range of columns
+		 */
+		Column_Range range() const { return Column_Range{ _start, _start + _size }; }
+
+		/*!
+		 *	@brief Get all columns of the family with a given value of the first index (e.g. all variables of day d)
+		 *  @param	first_index		The value of the first index
+		 *  @returns The range of columns
+		 */
+		Column_Range slice(size_t first_index) const
+		{
+			static_assert(Rank > 0, "A family of variables without indices cannot be sliced");
+			assert(first_index < _dimensions[0] && "Index variable exceeds range");
+			const size_t first = _start + first_index * _strides[0];
+			return Column_Range{ first, first + _strides[0] };
+		}
+	};
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	/*!
+	 *	@brief	Check whether a route can drive from location i to location j in segment k.
+	 *			The locations are ordered Z1...Zn, depot, CP1...CPk. A route leaves the depot
+	 *			for a zone in the first segment, drives from every zone to a collection point
+	 *			and from there to the next zone or back to the depot. Other arcs (self-loops,
+	 *			zone-zone, CP-CP, depot-CP, zone-depot, ...) and arcs in a segment that cannot
+	 *			be part of such a route are never used in a feasible solution.
+	 *  @param	nb_zones	The number of zones
+	 *  @param	nb_segments	The maximum number of segments of a route
+	 *  @param	i			The origin
+	 *  @param	j			The destination
+	 *  @param	k			The segment
+	 *  @returns True if the arc can be used
+	 */
+	inline bool structural_arc(size_t nb_zones, size_t nb_segments, size_t i, size_t j, size_t k)
+	{
+		const bool i_zone = i < nb_zones, i_depot = i == nb_zones, i_cp = i > nb_zones;
+		const bool j_zone = j < nb_zones, j_depot = j == nb_zones, j_cp = j > nb_zones;
+
+		if (i_depot && j_zone)	// first segment, followed by zone - CP and CP - depot
+			return k == 0 && k + 2 < nb_segments;
+		if (i_zone && j_cp)		// odd segments, followed by CP - zone or CP - depot
+			return k % 2 == 1 && k + 1 < nb_segments;
+		if (i_cp && j_zone)		// even segments, followed by zone - CP and CP - depot
+			return k % 2 == 0 && k > 0 && k + 2 < nb_segments;
+		if (i_cp && j_depot)	// even segments, last segment of the route
+			return k % 2 == 0 && k > 0;
+		return false;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	/*!
+	 *	@brief An arc (i,j) driven in segment k
+	 */
+	struct Arc
+	{
+		int i = 0;	///< The origin
+		int j = 0;	///< The destination
+		int k = 0;	///< The segment
+	};
+
+	/*!
+	 *	@brief	The arc variables x_gvijk (g = day or truck type, v = truck) of a routing model,
+	 *			with a column only for the allowed arcs (i,j,k) of every g
+	 */
+	class Arc_Family
+	{
+		/*!
+		 *	@brief The column index of the first variable of the family
+		 */
+		size_t _start = 0;
+
+		/*!
+		 *	@brief The number of trucks, locations and segments
+		 */
+		size_t _nb_trucks = 0;
+		size_t _nb_locations = 0;
+		size_t _nb_segments = 0;
+
+		/*!
+		 *	@brief The column index of the first variable of every value of the first index (plus one past the end)
+		 */
+		std::vector<size_t> _group_start{ 0 };
+
+		/*!
+		 *	@brief The allowed arcs of one truck for every value of the first index, in the order of the columns
+		 */
+		std::vector<std::vector<Arc>> _arcs;
+
+		/*!
+		 *	@brief The position of every arc (i,j,k) in _arcs for every value of the first index (-1 if not allowed)
+		 */
+		std::vector<std::vector<int>> _positions;
+
+		/*!
+		 *	@brief Position of arc (i,j,k) in the dense block of one truck
+		 */
+		size_t dense_index(size_t i, size_t j, size_t k) const { return (i * _nb_locations + j) * _nb_segments + k; }
+
+	public:
+		/*!
+		 *	@brief Default constructor (empty family at column 0)
+		 */
+		Arc_Family() = default;
+
+		/*!
+		 *	@brief Constructor
+		 *  @param	start			The column index of the first variable of the family
+		 *  @param	nb_groups		The number of values of the first index (days or truck types)
+		 *  @param	nb_trucks		The number of trucks
+		 *  @param	nb_locations	The number of locations
+		 *  @param	nb_segments		The number of segments
+		 *  @param	allowed			allowed(g, i, j, k) is true if the trucks of g can drive from i to j in segment k
+		 */
+		template<typename Allowed>
+		Arc_Family(size_t start, size_t nb_groups, size_t nb_trucks, size_t nb_locations, size_t nb_segments, Allowed allowed)
+			: _start(start), _nb_trucks(nb_trucks), _nb_locations(nb_locations), _nb_segments(nb_segments),
+			_group_start(nb_groups + 1, start), _arcs(nb_groups), _positions(nb_groups)
+		{
+			for (size_t g = 0; g < nb_groups; ++g)
+			{
+				_positions[g].assign(nb_locations * nb_locations * nb_segments, -1);
+				for (size_t i = 0; i < nb_locations; ++i)
+				{
+					for (size_t j = 0; j < nb_locations; ++j)
+					{
+						for (size_t k = 0; k < nb_segments; ++k)
+						{
+							if (allowed(g, i, j, k))
+							{
+								_positions[g][dense_index(i, j, k)] = static_cast<int>(_arcs[g].size());
+								_arcs[g].push_back(Arc{ static_cast<int>(i), static_cast<int>(j), static_cast<int>(k) });
+							}
+						}
+					}
+				}
+				_group_start[g + 1] = _group_start[g] + nb_trucks * _arcs[g].size();
+			}
+		}
+
+		/*!
+		 *	@brief Check whether arc (i,j,k) has a variable for the first index g
+		 *  @returns True if the arc is allowed
+		 */
+		bool contains(size_t g, size_t i, size_t j, size_t k) const
+		{
+			assert(g < _arcs.size() && i < _nb_locations && j < _nb_locations && k < _nb_segments && "Index variable exceeds range");
+			return _positions[g][dense_index(i, j, k)] >= 0;
+		}
+
+		/*!
+		 *	@brief Get the column index of variable x_gvijk (the arc must be allowed, see contains())
+		 *  @returns The column index
+		 */
+		size_t operator()(size_t g, size_t v, size_t i, size_t j, size_t k) const
+		{
+			assert(v < _nb_trucks && contains(g, i, j, k) && "Arc variable does not exist");
+			return _group_start[g] + v * _arcs[g].size() + static_cast<size_t>(_positions[g][dense_index(i, j, k)]);
+		}
+
+		/*!
+		 *	@brief Get the allowed arcs for the first index g, in the order of the columns of every truck
+		 *  @returns The arcs
+		 */
+		const std::vector<Arc>& arcs(size_t g) const { assert(g < _arcs.size()); return _arcs[g]; }
+
+		/*!
+		 *	@brief Get the column index of the first variable of the family
+		 *  @returns The column index
+		 */
+		size_t start() const { return _start; }
+
+		/*!
+		 *	@brief Get the column index one past the last variable of the family
+		 *  @returns The column index
+		 */
+		size_t end() const { return _group_start.back(); }
+
+		/*!
+		 *	@brief Get the number of variables in the family
+		 *  @returns The number of variables
+		 */
+		size_t size() const { return end() - _start; }
+
+		/*!
+		 *	@brief Get the number of variables of the dense family (all arcs in all segments)
+		 *  @returns The number of variables
+		 */
+		size_t dense_size() const { return _arcs.size() * _nb_trucks * _nb_locations * _nb_locations * _nb_segments; }
+
+		/*!
+		 *	@brief Get all columns of the family
+		 *  @returns The range of columns
+		 */
+		Column_Range range() const { return Column_Range{ _start, end() }; }
+
+		/*!
+		 *	@brief Get all columns with a given value of the first index (e.g. all variables of day d)
+		 *  @param	g	The value of the first index
+		 *  @returns The range of columns
+		 */
+		Column_Range slice(size_t g) const
+		{
+			assert(g < _arcs.size() && "Index variable exceeds range");
+			return Column_Range{ _group_start[g], _group_start[g + 1] };
+		}
+
+		/*!
+		 *	@brief Get all columns of truck v with a given value of the first index
+		 *  @param	g	The value of the first index
+		 *  @param	v	The truck
+		 *  @returns The range of columns
+		 */
+		Column_Range slice(size_t g, size_t v) const
+		{
+			assert(g < _arcs.size() && v < _nb_trucks && "Index variable exceeds range");
+			const size_t first = _group_start[g] + v * _arcs[g].size();
+			return Column_Range{ first, first + _arcs[g].size() };
+		}
+	};
+}
+
+
+#endif // !VARIABLE_LAYOUT_H